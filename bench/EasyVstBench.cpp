@@ -0,0 +1,325 @@
+// Headless process() benchmark. Build together with the EasyVst sources and EASYVST_HEADLESS defined, so that
+// neither SDL, PortAudio nor RtMidi is needed, e.g. as an "easyvst_bench" target next to the examples.
+#include <EasyVst.h>
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct BenchConfig {
+	int blockSize = 0;
+	int symbolicSampleSize = Steinberg::Vst::kSample32;
+	bool allBuses = false;
+	int eventsPerBlock = 0;
+};
+
+struct BenchResult {
+	BenchConfig config;
+	bool ok = false;
+	bool converting = false;
+	int activeAudioInputs = 0;
+	int activeAudioOutputs = 0;
+	Steinberg::int64 blocks = 0;
+	Steinberg::int64 frames = 0;
+	double realtimeFactor = 0.0;
+	double nsPerSample = 0.0;
+	double scheduleNsPerBlock = 0.0;
+	EasyVstProcessStats stats;
+};
+
+struct BenchOptions {
+	std::string path;
+	std::string classIdOrName;
+	std::string outputPath;
+	int sampleRate = 48000;
+	double seconds = 5.0;
+	double warmupSeconds = 0.5;
+	std::vector<int> blockSizes = { 32, 64, 128, 256, 512, 1024 };
+	std::vector<int> eventDensities = { 0, 4, 32 };
+};
+
+static std::vector<int> parseList(const std::string &text)
+{
+	std::vector<int> values;
+	std::istringstream iss(text);
+	std::string item;
+	while (std::getline(iss, item, ',')) {
+		if (!item.empty()) {
+			values.push_back(std::stoi(item));
+		}
+	}
+	return values;
+}
+
+static std::string jsonString(const std::string &text)
+{
+	std::ostringstream oss;
+	oss << '"';
+	for (char c : text) {
+		switch (c) {
+		case '"':
+			oss << "\\\"";
+			break;
+		case '\\':
+			oss << "\\\\";
+			break;
+		case '\n':
+			oss << "\\n";
+			break;
+		case '\t':
+			oss << "\\t";
+			break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20) {
+				oss << "\\u00" << "0123456789abcdef"[(c >> 4) & 0xf] << "0123456789abcdef"[c & 0xf];
+			} else {
+				oss << c;
+			}
+		}
+	}
+	oss << '"';
+	return oss.str();
+}
+
+static int activateBuses(EasyVst &vst, Steinberg::Vst::MediaType type, Steinberg::Vst::BusDirection direction, bool all)
+{
+	int numBuses = vst.numBuses(type, direction);
+	int numActive = all ? numBuses : std::min(numBuses, 1);
+	for (int i = 0; i < numActive; ++i) {
+		vst.setBusActive(type, direction, i, true);
+	}
+	return numActive;
+}
+
+static void fillInputs(EasyVst &vst, int numBuses, int blockSize)
+{
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+
+	for (int bus = 0; bus < numBuses; ++bus) {
+		int numChannels = vst.busInfo(Steinberg::Vst::kAudio, Steinberg::Vst::kInput, bus)->channelCount;
+		std::vector<float> interleaved(static_cast<size_t>(numChannels) * blockSize);
+		for (float &sample : interleaved) {
+			sample = noise(rng);
+		}
+		vst.copyFromInterleaved(bus, interleaved.data(), EasyVstSampleFormat::kFloat32, numChannels, blockSize);
+	}
+}
+
+static void scheduleBlockEvents(EasyVst &vst, int eventsPerBlock, int blockSize, Steinberg::int64 blockIndex)
+{
+	for (int i = 0; i < eventsPerBlock; ++i) {
+		Steinberg::Vst::Event event = {};
+		event.busIndex = 0;
+		int pitch = 36 + static_cast<int>((blockIndex * eventsPerBlock + i) / 2 % 48);
+		if (i % 2 == 0) {
+			event.type = Steinberg::Vst::Event::kNoteOnEvent;
+			event.noteOn.pitch = pitch;
+			event.noteOn.velocity = 0.8f;
+			event.noteOn.noteId = -1;
+		} else {
+			event.type = Steinberg::Vst::Event::kNoteOffEvent;
+			event.noteOff.pitch = pitch;
+			event.noteOff.noteId = -1;
+		}
+		Steinberg::int64 offset = static_cast<Steinberg::int64>(i) * blockSize / eventsPerBlock;
+		vst.scheduleEvent(event, vst.samplePosition() + offset);
+	}
+}
+
+static BenchResult runConfig(const BenchOptions &options, const BenchConfig &config)
+{
+	BenchResult result;
+	result.config = config;
+
+	EasyVst vst;
+	if (!vst.init(options.path, options.classIdOrName, options.sampleRate, config.blockSize, config.symbolicSampleSize, true)) {
+		return result;
+	}
+	result.converting = vst.isConvertingSampleSize();
+
+	result.activeAudioInputs = activateBuses(vst, Steinberg::Vst::kAudio, Steinberg::Vst::kInput, config.allBuses);
+	result.activeAudioOutputs = activateBuses(vst, Steinberg::Vst::kAudio, Steinberg::Vst::kOutput, config.allBuses);
+	int activeEventInputs = activateBuses(vst, Steinberg::Vst::kEvent, Steinberg::Vst::kInput, config.allBuses);
+	activateBuses(vst, Steinberg::Vst::kEvent, Steinberg::Vst::kOutput, config.allBuses);
+
+	int eventsPerBlock = activeEventInputs > 0 ? config.eventsPerBlock : 0;
+	fillInputs(vst, result.activeAudioInputs, config.blockSize);
+	vst.setProcessing(true);
+
+	Steinberg::int64 warmupBlocks = std::max<Steinberg::int64>(1, static_cast<Steinberg::int64>(options.warmupSeconds * options.sampleRate / config.blockSize));
+	Steinberg::int64 timedBlocks = std::max<Steinberg::int64>(1, static_cast<Steinberg::int64>(options.seconds * options.sampleRate / config.blockSize));
+
+	for (Steinberg::int64 i = 0; i < warmupBlocks; ++i) {
+		scheduleBlockEvents(vst, eventsPerBlock, config.blockSize, i);
+		if (!vst.process(config.blockSize)) {
+			vst.setProcessing(false);
+			return result;
+		}
+	}
+
+	// Only process() is timed; scheduling the block's events is reported on its own
+	vst.resetProcessStats();
+	Steinberg::int64 processNs = 0, scheduleNs = 0;
+	for (Steinberg::int64 i = 0; i < timedBlocks; ++i) {
+		Steinberg::int64 scheduleStartNs = EasyVst::hostTimeNs();
+		scheduleBlockEvents(vst, eventsPerBlock, config.blockSize, warmupBlocks + i);
+		Steinberg::int64 processStartNs = EasyVst::hostTimeNs();
+		bool processed = vst.process(config.blockSize);
+		Steinberg::int64 endNs = EasyVst::hostTimeNs();
+
+		scheduleNs += processStartNs - scheduleStartNs;
+		processNs += endNs - processStartNs;
+		if (!processed) {
+			std::cerr << "process() failed in timed block " << i << " at block size " << config.blockSize << std::endl;
+			vst.setProcessing(false);
+			return result;
+		}
+	}
+
+	vst.setProcessing(false);
+
+	result.ok = true;
+	result.blocks = timedBlocks;
+	result.frames = timedBlocks * config.blockSize;
+	result.stats = vst.processStats();
+	result.scheduleNsPerBlock = static_cast<double>(scheduleNs) / timedBlocks;
+	if (processNs > 0) {
+		result.realtimeFactor = (result.frames / static_cast<double>(options.sampleRate)) / (processNs / 1e9);
+		result.nsPerSample = static_cast<double>(processNs) / result.frames;
+	}
+
+	return result;
+}
+
+static void writeJson(std::ostream &out, const BenchOptions &options, const std::vector<BenchResult> &results)
+{
+	out << "{\n";
+	out << "\t\"plugin\": " << jsonString(options.path) << ",\n";
+	out << "\t\"class\": " << jsonString(options.classIdOrName) << ",\n";
+	out << "\t\"sampleRate\": " << options.sampleRate << ",\n";
+	out << "\t\"seconds\": " << options.seconds << ",\n";
+	out << "\t\"results\": [";
+	for (size_t i = 0; i < results.size(); ++i) {
+		const BenchResult &result = results[i];
+		out << (i == 0 ? "\n" : ",\n");
+		out << "\t\t{";
+		out << "\"blockSize\": " << result.config.blockSize;
+		out << ", \"sampleSize\": " << (result.config.symbolicSampleSize == Steinberg::Vst::kSample64 ? 64 : 32);
+		out << ", \"buses\": " << jsonString(result.config.allBuses ? "all" : "main");
+		out << ", \"eventsPerBlock\": " << result.config.eventsPerBlock;
+		out << ", \"ok\": " << (result.ok ? "true" : "false");
+		if (result.ok) {
+			out << ", \"converting\": " << (result.converting ? "true" : "false");
+			out << ", \"activeAudioInputs\": " << result.activeAudioInputs;
+			out << ", \"activeAudioOutputs\": " << result.activeAudioOutputs;
+			out << ", \"blocks\": " << result.blocks;
+			out << ", \"realtimeFactor\": " << result.realtimeFactor;
+			out << ", \"nsPerSample\": " << result.nsPerSample;
+			out << ", \"scheduleNsPerBlock\": " << result.scheduleNsPerBlock;
+			out << ", \"minNs\": " << result.stats.minNs;
+			out << ", \"p50Ns\": " << result.stats.p50Ns;
+			out << ", \"p99Ns\": " << result.stats.p99Ns;
+			out << ", \"maxNs\": " << result.stats.maxNs;
+			out << ", \"peakLoad\": " << result.stats.peakLoad;
+			out << ", \"overruns\": " << result.stats.overruns;
+			out << ", \"failures\": " << result.stats.failures;
+		}
+		out << "}";
+	}
+	out << "\n\t]\n";
+	out << "}\n";
+}
+
+static void printUsage(const char *program)
+{
+	std::cerr << "Usage: " << program << " [VST plugin filename].vst3 [options]" << std::endl;
+	std::cerr << "  --class <uid or name>     Audio effect class to instantiate" << std::endl;
+	std::cerr << "  --sample-rate <hz>        Sample rate (default 48000)" << std::endl;
+	std::cerr << "  --seconds <s>             Audio length timed per configuration (default 5)" << std::endl;
+	std::cerr << "  --block-sizes <a,b,...>   Block sizes (default 32,64,128,256,512,1024)" << std::endl;
+	std::cerr << "  --events <a,b,...>        Events per block (default 0,4,32)" << std::endl;
+	std::cerr << "  --output <file.json>      Write results to a file instead of stdout" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	BenchOptions options;
+	options.path = argv[1];
+	for (int i = 2; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (i + 1 >= argc) {
+			printUsage(argv[0]);
+			return 1;
+		}
+		std::string value = argv[++i];
+		if (arg == "--class") {
+			options.classIdOrName = value;
+		} else if (arg == "--sample-rate") {
+			options.sampleRate = std::stoi(value);
+		} else if (arg == "--seconds") {
+			options.seconds = std::stod(value);
+		} else if (arg == "--block-sizes") {
+			options.blockSizes = parseList(value);
+		} else if (arg == "--events") {
+			options.eventDensities = parseList(value);
+		} else if (arg == "--output") {
+			options.outputPath = value;
+		} else {
+			printUsage(argv[0]);
+			return 1;
+		}
+	}
+
+	// EasyVst prints debug info to stdout; keep it out of the JSON
+	std::streambuf *stdoutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+
+	std::vector<BenchResult> results;
+	for (int blockSize : options.blockSizes) {
+		for (int symbolicSampleSize : { Steinberg::Vst::kSample32, Steinberg::Vst::kSample64 }) {
+			for (bool allBuses : { false, true }) {
+				for (int eventsPerBlock : options.eventDensities) {
+					BenchConfig config;
+					config.blockSize = blockSize;
+					config.symbolicSampleSize = symbolicSampleSize;
+					config.allBuses = allBuses;
+					config.eventsPerBlock = eventsPerBlock;
+
+					BenchResult result = runConfig(options, config);
+					std::cerr << "block " << blockSize << ", " << (symbolicSampleSize == Steinberg::Vst::kSample64 ? 64 : 32) << "-bit, ";
+					std::cerr << (allBuses ? "all" : "main") << " buses, " << eventsPerBlock << " events: ";
+					if (result.ok) {
+						std::cerr << result.realtimeFactor << "x realtime, " << result.nsPerSample << " ns/sample" << std::endl;
+					} else {
+						std::cerr << "failed" << std::endl;
+					}
+					results.push_back(result);
+				}
+			}
+		}
+	}
+
+	std::cout.rdbuf(stdoutBuffer);
+
+	if (options.outputPath.empty()) {
+		writeJson(std::cout, options, results);
+	} else {
+		std::ofstream file(options.outputPath);
+		if (!file) {
+			std::cerr << "Failed to open " << options.outputPath << std::endl;
+			return 1;
+		}
+		writeJson(file, options, results);
+	}
+
+	return 0;
+}
@@ -1,8 +1,6 @@
 // https://github.com/blitcrush/EasyVst
 #include <EasyVst.h>
 
-// https://github.com/cameron314/concurrentqueue
-#include <concurrentqueue.h>
 // http://portaudio.com/
 #include <portaudio.h>
 //
@@ -14,18 +12,10 @@
 #include <RtMidi.h>
 
 #include <iostream>
-#include <chrono>
-
-struct MidiNoteMessage {
-        int noteNum = -1;
-        float velocity = 0.0f;
-        bool isNoteOn = false;
-};
 
 struct UserData {
         EasyVst vst;
-        uint64_t continuousSamples = 0;
-        moodycamel::ConcurrentQueue<MidiNoteMessage> notesQueue;
+        std::shared_ptr<EasyVstTransport> transport = std::make_shared<EasyVstTransport>();
 };
 
 static const double TEMPO = 120.0;
@@ -37,70 +27,13 @@ static int audioCallback(const void *inputBuffer, void *pOutputBuffer, unsigned
         float *outputBuffer = static_cast<float *>(pOutputBuffer);
         UserData *userData = static_cast<UserData *>(pUserData);
 
-        double currentBeat = userData->continuousSamples / ((60.0 / TEMPO) * static_cast<double>(SAMPLE_RATE));
-
-        Steinberg::Vst::ProcessContext *processContext = userData->vst.processContext();
-        processContext->state = Steinberg::Vst::ProcessContext::kPlaying;
-        processContext->sampleRate = SAMPLE_RATE;
-        processContext->projectTimeSamples = userData->continuousSamples;
-        processContext->state |= Steinberg::Vst::ProcessContext::kTempoValid;
-        processContext->tempo = TEMPO;
-        processContext->state |= Steinberg::Vst::ProcessContext::kTimeSigValid;
-        processContext->timeSigNumerator = 4;
-        processContext->timeSigDenominator = 4;
-        processContext->state |= Steinberg::Vst::ProcessContext::kContTimeValid;
-        processContext->continousTimeSamples = userData->continuousSamples;
-        processContext->state |= Steinberg::Vst::ProcessContext::kSystemTimeValid;
-        processContext->systemTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-        processContext->state |= Steinberg::Vst::ProcessContext::kProjectTimeMusicValid;
-        processContext->projectTimeMusic = currentBeat;
-        userData->continuousSamples += framesPerBuffer;
-
-        Steinberg::Vst::EventList *eventList = userData->vst.eventList(Steinberg::Vst::kInput, 0);
-        while (true) {
-                MidiNoteMessage note;
-                bool hasNotes = userData->notesQueue.try_dequeue(note);
-                if (!hasNotes) {
-                        break;
-                }
-                
-                Steinberg::Vst::Event evt = {};
-                evt.busIndex = 0;
-                evt.sampleOffset = 0;
-                evt.ppqPosition = currentBeat;
-                evt.flags = Steinberg::Vst::Event::EventFlags::kIsLive;
-                if (note.isNoteOn) {
-                        evt.type = Steinberg::Vst::Event::EventTypes::kNoteOnEvent;
-                        evt.noteOn.channel = 0;
-                        evt.noteOn.pitch = note.noteNum;
-                        evt.noteOn.tuning = 0.0f;
-                        evt.noteOn.velocity = note.velocity;
-                        evt.noteOn.length = 0;
-                        evt.noteOn.noteId = -1;
-                } else {
-                        evt.type = Steinberg::Vst::Event::EventTypes::kNoteOffEvent;
-                        evt.noteOff.channel = 0;
-                        evt.noteOff.pitch = note.noteNum;
-                        evt.noteOff.tuning = 0.0f;
-                        evt.noteOff.velocity = note.velocity;
-                        evt.noteOff.noteId = -1;
-                }
-                eventList->addEvent(evt);
-        }
-
         if (!userData->vst.process(framesPerBuffer)) {
                 std::cerr << "VST process() failed" << std::endl;
                 return 1;
         }
 
-        eventList->clear();
-
-        float *left = userData->vst.channelBuffer32(Steinberg::Vst::kOutput, 0);
-        float *right = userData->vst.channelBuffer32(Steinberg::Vst::kOutput, 0);
-        for (unsigned long i = 0; i < framesPerBuffer; ++i) {
-                outputBuffer[i * 2 + 0] = left[i];
-                outputBuffer[i * 2 + 1] = right[i];
-        }
+        userData->vst.copyToInterleaved(0, outputBuffer, EasyVstSampleFormat::kFloat32, 2, framesPerBuffer);
+        userData->transport->advance(framesPerBuffer);
 
         return 0;
 }
@@ -117,19 +50,30 @@ void midiCallback(double deltaTime, std::vector<unsigned char> *message, void *p
 
         UserData *userData = static_cast<UserData *>(pUserData);
 
+        Steinberg::Vst::Event evt = {};
+        evt.busIndex = 0;
+        evt.flags = Steinberg::Vst::Event::EventFlags::kIsLive;
         if (command == 144) {
-                MidiNoteMessage noteOnMsg;
-                noteOnMsg.noteNum = noteNum;
-                noteOnMsg.velocity = static_cast<float>(velocity) / 127.0f;
-                noteOnMsg.isNoteOn = true;
-                userData->notesQueue.enqueue(noteOnMsg);
+                evt.type = Steinberg::Vst::Event::EventTypes::kNoteOnEvent;
+                evt.noteOn.channel = 0;
+                evt.noteOn.pitch = noteNum;
+                evt.noteOn.tuning = 0.0f;
+                evt.noteOn.velocity = static_cast<float>(velocity) / 127.0f;
+                evt.noteOn.length = 0;
+                evt.noteOn.noteId = -1;
         } else if (command == 128) {
-                MidiNoteMessage noteOffMsg;
-                noteOffMsg.noteNum = noteNum;
-                noteOffMsg.velocity = static_cast<float>(velocity) / 127.0f;
-                noteOffMsg.isNoteOn = false;
-                userData->notesQueue.enqueue(noteOffMsg);
+                evt.type = Steinberg::Vst::Event::EventTypes::kNoteOffEvent;
+                evt.noteOff.channel = 0;
+                evt.noteOff.pitch = noteNum;
+                evt.noteOff.tuning = 0.0f;
+                evt.noteOff.velocity = static_cast<float>(velocity) / 127.0f;
+                evt.noteOff.noteId = -1;
+        } else {
+                return;
         }
+
+        // Stamp the note with its arrival time so it keeps its position inside the next audio block
+        userData->vst.scheduleEventAtTime(evt, EasyVst::hostTimeNs());
 }
 
 int main(int argc, char *argv[])
@@ -140,6 +84,11 @@ int main(int argc, char *argv[])
         }
 
         UserData userData;
+        userData.transport->setSampleRate(SAMPLE_RATE);
+        userData.transport->setTempo(TEMPO);
+        userData.transport->setTimeSignature(4, 4);
+        userData.transport->setPlaying(true);
+        userData.vst.setTransport(userData.transport);
 
         if (!userData.vst.init(argv[1], SAMPLE_RATE, MAX_BLOCK_SIZE, Steinberg::Vst::kSample32, true)) {
                 std::cerr << "Failed to initialize VST" << std::endl;
@@ -236,6 +185,7 @@ int main(int argc, char *argv[])
                         }
                         userData.vst.processSdlEvent(evt);
                 }
+                userData.vst.applyOutputParameterChanges();
 
                 Pa_Sleep(16);
         }
@@ -2,6 +2,28 @@
 
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <EasyVstRingBuffer.h>
+#include <EasyVstSampleConvert.h>
+#include <EasyVstMetrics.h>
+#include <EasyVstAudit.h>
+#include <EasyVstComponentHandler.h>
+#include <EasyVstArena.h>
+#include <EasyVstState.h>
+#include <EasyVstParameterIndex.h>
+#include <EasyVstTransport.h>
+#include <EasyVstTrace.h>
 
 #include <public.sdk/source/vst/hosting/plugprovider.h>
 #include <public.sdk/source/vst/hosting/module.h>
@@ -13,39 +35,194 @@
 #include <pluginterfaces/vst/ivstprocesscontext.h>
 #include <pluginterfaces/gui/iplugview.h>
 
+#ifndef EASYVST_HEADLESS
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_syswm.h>
+#endif
+
+class EasyVstGraph;
+class EasyVstScanner;
+class EasyVstSandbox;
+class EasyVstPresetSwap;
+
+enum class EasyVstSilencePolicy {
+	kAlwaysProcess,
+	kSkipWhenSilent
+};
 
 class EasyVst {
+	friend class EasyVstGraph;
+	friend class EasyVstScanner;
+	friend class EasyVstSandbox;
+	friend class EasyVstPresetSwap;
+
 public:
+	static constexpr int MAX_TAIL_SECONDS = 30;
+
 	EasyVst();
 	~EasyVst();
 
 	bool init(const std::string &path, int sampleRate, int maxBlockSize, int symbolicSampleSize, bool realtime);
+	bool init(const std::string &path, const std::string &classIdOrName, int sampleRate, int maxBlockSize, int symbolicSampleSize, bool realtime);
+	bool initSandboxed(const std::string &path, int sampleRate, int maxBlockSize, int symbolicSampleSize, bool realtime);
+	// Runs init() on a detached thread; the future does not block when discarded, but the instance must
+	// outlive the load
+	std::future<bool> initAsync(const std::string &path, const std::string &classIdOrName, int sampleRate, int maxBlockSize, int symbolicSampleSize, bool realtime, std::function<void(EasyVst &, bool)> done = nullptr);
+	void setArena(std::shared_ptr<EasyVstArena> arena);
+	// Invalidates any EasyVstGraph the instance belongs to until the graph's prepare() runs again
+	bool reconfigure(int sampleRate, int maxBlockSize, int symbolicSampleSize, bool realtime);
+	bool sandboxCrashed() const;
 	void destroy();
 
 	Steinberg::Vst::ProcessContext *processContext();
+	void setTransport(std::shared_ptr<EasyVstTransport> transport);
+	Steinberg::uint32 processContextRequirements() const;
 	void setProcessing(bool processing);
 	bool process(int numSamples);
+	bool reset();
+
+	void setSilencePolicy(EasyVstSilencePolicy policy);
+	EasyVstSilencePolicy silencePolicy() const;
+	Steinberg::uint64 skippedBlocks() const;
+
+	// Renders audio bus 0 only: inputs and outputs hold one channel per numChannels(direction, 0) and either may
+	// be null, other buses are processed with whatever their buffers hold. Outputs must hold totalFrames +
+	// maxTailFrames frames; a negative maxTailFrames renders tailSamples() frames. A shared transport only
+	// provides the starting position and is not advanced by the render.
+	bool renderOffline(const Steinberg::Vst::Sample32 *const *inputs, Steinberg::Vst::Sample32 *const *outputs, Steinberg::int64 totalFrames, Steinberg::int64 maxTailFrames = -1);
+	bool renderOffline(const Steinberg::Vst::Sample64 *const *inputs, Steinberg::Vst::Sample64 *const *outputs, Steinberg::int64 totalFrames, Steinberg::int64 maxTailFrames = -1);
+	// The plugin's tail, with an infinite or longer one capped at MAX_TAIL_SECONDS
+	Steinberg::int64 tailSamples();
 
 	const Steinberg::Vst::BusInfo *busInfo(Steinberg::Vst::MediaType type, Steinberg::Vst::BusDirection direction, int which);
 	int numBuses(Steinberg::Vst::MediaType type, Steinberg::Vst::BusDirection direction);
+	int numChannels(Steinberg::Vst::BusDirection direction, int which);
 	void setBusActive(Steinberg::Vst::MediaType type, Steinberg::Vst::BusDirection direction, int which, bool active);
 
+	Steinberg::uint32 latencySamples() const;
+	bool latencyChangePending() const;
+	// Restarts the component to apply a pending latency change; only valid after setProcessing(false), with
+	// no process() running, and returns false while processing. Returns true when the latency changed.
+	bool updateLatency();
+
 	Steinberg::Vst::Sample32 *channelBuffer32(Steinberg::Vst::BusDirection direction, int which);
 	Steinberg::Vst::Sample64 *channelBuffer64(Steinberg::Vst::BusDirection direction, int which);
 
+	// Each channel must be 16-byte aligned and hold at least the maximum block size
+	bool bindBuffers(Steinberg::Vst::BusDirection direction, int which, Steinberg::Vst::Sample32 *const *channelBuffers, int numChannels, int capacityFrames, bool persistent);
+	bool bindBuffers(Steinberg::Vst::BusDirection direction, int which, Steinberg::Vst::Sample64 *const *channelBuffers, int numChannels, int capacityFrames, bool persistent);
+	// Input buses an EasyVstGraph feeds by pointer cannot be bound or unbound here
+	void unbindBuffers(Steinberg::Vst::BusDirection direction, int which);
+
+	bool copyFromInterleaved(int bus, const void *interleaved, EasyVstSampleFormat format, int frameChannels, int numFrames, float gain = 1.0f);
+	bool copyToInterleaved(int bus, void *interleaved, EasyVstSampleFormat format, int frameChannels, int numFrames, float gain = 1.0f);
+	bool isConvertingSampleSize() const;
+
 	Steinberg::Vst::EventList *eventList(Steinberg::Vst::BusDirection direction, int which);
 	Steinberg::Vst::ParameterChanges *parameterChanges(Steinberg::Vst::BusDirection direction, int which);
 
+	void setParameterQueueCapacity(int capacity);
+	bool queueParameterChange(Steinberg::Vst::ParamID id, Steinberg::Vst::ParamValue normalizedValue, Steinberg::int64 samplePosition);
+	int applyOutputParameterChanges();
+	std::shared_ptr<const EasyVstParameterIndex> parameterIndex() const;
+	bool updateParameterIndex();
+	Steinberg::Vst::ParamValue normalizedToPlain(Steinberg::Vst::ParamID id, Steinberg::Vst::ParamValue normalizedValue);
+	Steinberg::Vst::ParamValue plainToNormalized(Steinberg::Vst::ParamID id, Steinberg::Vst::ParamValue plainValue);
+	Steinberg::uint64 parameterQueueOverflows() const;
+	Steinberg::uint64 outputParameterQueueOverflows() const;
+	Steinberg::int64 samplePosition() const;
+
+	void setEventCapacity(int capacity);
+	bool scheduleEvent(const Steinberg::Vst::Event &event, Steinberg::int64 samplePosition);
+	bool scheduleEventAtTime(const Steinberg::Vst::Event &event, Steinberg::int64 hostTimeNs);
+	Steinberg::uint64 eventOverflows() const;
+	static Steinberg::int64 hostTimeNs();
+
+	EasyVstProcessStats processStats() const;
+	void resetProcessStats();
+
+	bool setAuditEnabled(bool enabled, int capacity = 1024);
+	int collectAuditRecords(std::vector<EasyVstAuditRecord> &records);
+	Steinberg::uint64 auditOverflows() const;
+
+	bool saveState(EasyVstState &state);
+	bool loadState(EasyVstState &state);
+
 	bool createView();
 	void destroyView();
+#ifndef EASYVST_HEADLESS
 	static void processSdlEvent(const SDL_Event &event);
+#endif
 
 	const std::string &name();
 
 private:
+	struct ParameterChangePoint {
+		Steinberg::Vst::ParamID id = 0;
+		Steinberg::Vst::ParamValue value = 0.0;
+		Steinberg::int64 samplePosition = 0;
+	};
+
+	struct ScheduledEvent {
+		Steinberg::Vst::Event event = {};
+		Steinberg::int64 time = 0;
+		bool isHostTime = false;
+		Steinberg::uint32 sequence = 0;
+	};
+
+	struct ArenaChannel {
+		void *memory = nullptr;
+		size_t bytes = 0;
+		bool used = false;
+	};
+
 	void _destroy(bool decrementRefCount);
+	void _configure(const std::string &path, int sampleRate, int maxBlockSize, int symbolicSampleSize, bool realtime);
+
+	bool _process(int numSamples);
+	bool _setProcessMode(Steinberg::int32 processMode);
+	void _advanceProcessContext(int numSamples);
+	void _prepareParameterChanges();
+	void _drainParameterQueue(int numSamples);
+	void _addParameterPoint(const ParameterChangePoint &change);
+	void _drainOutputParameterChanges();
+	bool _prepareEventScheduler();
+	Steinberg::Vst::EventList *_createEventLists(int count);
+	void _destroyEventLists(Steinberg::Vst::EventList *&lists, int count);
+	void _drainEventQueue(int numSamples);
+	void _mergeInputEventBuses();
+	static void _sortEvents(Steinberg::Vst::EventList &events);
+
+	bool _updateInputSilence(int numSamples);
+	bool _updateOutputSilence(int numSamples);
+	bool _canSkipBlock(bool inputSilent, int numSamples);
+	void _skipBlock(int numSamples);
+
+	bool _prepareBuffers(Steinberg::int32 pluginSampleSize);
+	bool _placeChannelBuffers(Steinberg::Vst::ProcessData &data, Steinberg::int32 sampleSize);
+	void *_allocateArenaChannel(size_t bytes);
+	Steinberg::Vst::AudioBusBuffers *_hostBuses(Steinberg::Vst::BusDirection direction);
+	void _convertBuses(Steinberg::Vst::BusDirection direction, int numSamples);
+	void _snapshotChannelBuffers();
+	void _restoreChannelBuffers();
+	void *_channelBuffer(Steinberg::Vst::BusDirection direction, int which, int channel);
+	void _bindAudioBus(Steinberg::Vst::BusDirection direction, int which, void *const *channelBuffers);
+	void _unbindAudioBus(Steinberg::Vst::BusDirection direction, int which);
+	void _releaseOneShotBindings();
+
+	template <typename SampleType>
+	bool _bindBuffers(Steinberg::Vst::BusDirection direction, int which, SampleType *const *channelBuffers, int numChannels, int capacityFrames, bool persistent);
+	void _bindInputEvents(Steinberg::Vst::IEventList *events);
+	void _shareInputBus(int which, void *const *channelBuffers);
+	void _unshareInputBus(int which);
+
+	template <typename SampleType>
+	bool _renderOffline(const SampleType *const *inputs, SampleType *const *outputs, Steinberg::int64 totalFrames, Steinberg::int64 maxTailFrames);
+
+	static VST3::Hosting::Module::Ptr _loadModule(const std::string &path, std::string &error);
+	static std::shared_ptr<const EasyVstParameterIndex> _loadParameterIndex(const std::string &key, Steinberg::Vst::IEditController *controller);
+	static void _acquirePluginContext();
+	static void _releasePluginContext();
 
 	void _printDebug(const std::string &info);
 	void _printError(const std::string &error);
@@ -64,19 +241,72 @@ private:
 	Steinberg::IPtr<Steinberg::Vst::IComponent> _vstPlug = nullptr;
 	Steinberg::IPtr<Steinberg::Vst::IAudioProcessor> _audioEffect = nullptr;
 	Steinberg::IPtr<Steinberg::Vst::IEditController> _editController = nullptr;
+	EasyVstComponentHandler _componentHandler;
+	std::shared_ptr<const EasyVstParameterIndex> _parameterIndex;
 	Steinberg::Vst::HostProcessData _processData = {};
 	Steinberg::Vst::ProcessSetup _processSetup = {};
 	Steinberg::Vst::ProcessContext _processContext = {};
+	std::shared_ptr<EasyVstTransport> _transport;
+	Steinberg::uint32 _contextRequirements = ~0u;
+
+	Steinberg::Vst::HostProcessData _hostBuffers;
+	bool _convertSampleSize = false;
+
+	Steinberg::Vst::EventList *_inEventLists = nullptr, *_outEventLists = nullptr;
+	Steinberg::Vst::IEventList *_sharedInputEvents = nullptr;
+	std::vector<std::vector<void *>> _ownedChannelBuffers[2];
+	std::vector<int> _bindingCapacity[2];
+	std::vector<bool> _graphInputs;
+	std::shared_ptr<EasyVstArena> _arena, _activeArena;
+	std::vector<ArenaChannel> _arenaChannels;
+	std::vector<std::pair<Steinberg::Vst::BusDirection, int>> _oneShotBindings;
+
+	Steinberg::Vst::ParameterChanges _inParameterChanges, _outParameterChanges;
+	EasyVstRingBuffer<ParameterChangePoint> _parameterQueue, _outputParameterQueue;
+	std::vector<ParameterChangePoint> _pendingParameterChanges;
+	int _parameterQueueCapacity = 1024;
+	std::atomic<Steinberg::uint64> _parameterQueueOverflows{0}, _outputParameterQueueOverflows{0};
+	std::atomic<Steinberg::int64> _samplePosition{0};
+
+	EasyVstRingBuffer<ScheduledEvent> _eventQueue;
+	std::vector<ScheduledEvent> _pendingEvents, _dueEvents;
+	int _eventCapacity = 1024;
+	Steinberg::uint32 _eventSequence = 0;
+	std::atomic<Steinberg::uint64> _eventOverflows{0};
+
+	EasyVstMetrics _metrics;
+
+	std::atomic<EasyVstSilencePolicy> _silencePolicy{EasyVstSilencePolicy::kAlwaysProcess};
+	std::atomic<Steinberg::uint64> _skippedBlocks{0};
+	Steinberg::int64 _silentInputSamples = 0, _silenceTailSamples = -1;
+	bool _outputSilent = false;
+	EasyVstAudit _audit;
 
 	Steinberg::IPtr<Steinberg::IPlugView> _view = nullptr;
+#ifndef EASYVST_HEADLESS
 	SDL_Window *_window = nullptr;
+#endif
+
+	EasyVstSandbox *_sandbox = nullptr;
 
 	int _sampleRate = 0, _maxBlockSize = 0, _symbolicSampleSize = 0;
+	int _preparedBlockSize = 0;
+	Steinberg::uint32 _bufferGeneration = 0;
 	bool _realtime = false;
+	bool _processing = false;
+	bool _holdsPluginContext = false;
+	std::atomic<Steinberg::uint32> _latencySamples{0};
 
 	std::string _path;
 	std::string _name;
 
 	static Steinberg::Vst::HostApplication *_standardPluginContext;
-	static int _standardPluginContextRefCount;
+	static std::atomic<int> _standardPluginContextRefCount;
+	static std::mutex _pluginContextMutex;
+
+	static std::mutex _moduleCacheMutex;
+	static std::unordered_map<std::string, std::weak_ptr<VST3::Hosting::Module>> _moduleCache;
+
+	static std::mutex _parameterIndexCacheMutex;
+	static std::unordered_map<std::string, std::weak_ptr<const EasyVstParameterIndex>> _parameterIndexCache;
 };
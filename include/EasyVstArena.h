@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Bump allocator for the process buffers of a group of EasyVst instances. Memory is mapped in chunks
+// (2 MiB by default, hugepage-backed when requested and available) and optionally locked; allocations are
+// cache-line aligned and placed in the order the instances are initialized, so initializing a group in
+// processing order lays its buffers out in that order. Nothing is freed until release(), which unmaps
+// every chunk at once; share one arena between instances through EasyVst::setArena() and it is released
+// with the last of them. An instance that reconfigures, or is initialized again with the same arena, reuses
+// its earlier channels and only takes new memory for the ones that no longer fit; its event list objects
+// are placed anew on every init, so repeated inits grow the arena by those. Audio channels and event list
+// objects live in the arena; the bus arrays and the SDK's event and parameter queues still allocate their
+// own storage. Call release() only once no instance that used the arena will be initialized again.
+class EasyVstArena {
+public:
+	static constexpr size_t CACHE_LINE_SIZE = 64;
+
+	EasyVstArena();
+	~EasyVstArena();
+
+	bool reserve(size_t chunkSize, bool hugePages, bool lockMemory);
+	void *allocate(size_t size, size_t alignment = CACHE_LINE_SIZE);
+	void release();
+
+	size_t bytesUsed() const;
+	size_t bytesMapped() const;
+	bool usesHugePages() const;
+	bool isLocked() const;
+
+private:
+	struct Chunk {
+		char *memory = nullptr;
+		size_t size = 0;
+		size_t used = 0;
+		bool hugePages = false;
+		bool locked = false;
+	};
+
+	bool _mapChunk(size_t minSize);
+	static void _unmapChunk(const Chunk &chunk);
+
+	void _printError(const std::string &error);
+
+	mutable std::mutex _mutex;
+	std::vector<Chunk> _chunks;
+	size_t _chunkSize = 2 << 20;
+	bool _hugePages = false;
+	bool _lockMemory = false;
+};
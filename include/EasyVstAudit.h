@@ -0,0 +1,62 @@
+#pragma once
+
+#include <EasyVstRingBuffer.h>
+
+#include <pluginterfaces/base/funknown.h>
+
+#include <string>
+#include <vector>
+
+enum class EasyVstAuditKind {
+	kAllocation,
+	kDeallocation,
+	kMutexWait,
+	kFileIo,
+	kSocketIo
+};
+
+struct EasyVstAuditRecord {
+	static const int MAX_FRAMES = 24;
+
+	EasyVstAuditKind kind = EasyVstAuditKind::kAllocation;
+	const char *function = nullptr;
+	size_t size = 0;
+	Steinberg::int64 samplePosition = 0;
+	int numFrames = 0;
+	void *frames[MAX_FRAMES] = {};
+};
+
+// Catches real-time violations made by a plugin while its process() call runs on the current thread.
+// With EASYVST_AUDIT defined, EasyVstAudit.cpp interposes malloc/free, operator new/delete, contended
+// pthread_mutex_lock and common file and socket calls; each one made between begin() and end() is pushed
+// with a backtrace onto a preallocated queue for collect() on another thread. Interposition only takes
+// effect when this file is linked into the executable itself or preloaded.
+class EasyVstAudit {
+public:
+	EasyVstAudit();
+	~EasyVstAudit();
+
+	static bool isAvailable();
+
+	// Not thread-safe; call while the audited instance is not processing
+	bool enable(int capacity);
+	void disable();
+	bool isEnabled() const;
+
+	void begin(Steinberg::int64 samplePosition);
+	void end();
+
+	int collect(std::vector<EasyVstAuditRecord> &records);
+	Steinberg::uint64 overflows() const;
+
+	static const char *kindName(EasyVstAuditKind kind);
+	static std::vector<std::string> symbolize(const EasyVstAuditRecord &record);
+
+	static void report(EasyVstAuditKind kind, const char *function, size_t size);
+
+private:
+	EasyVstRingBuffer<EasyVstAuditRecord> _records;
+	std::atomic<bool> _enabled{false};
+	std::atomic<Steinberg::uint64> _overflows{0};
+	Steinberg::int64 _samplePosition = 0;
+};
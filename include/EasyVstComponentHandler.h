@@ -0,0 +1,32 @@
+#pragma once
+
+#include <pluginterfaces/vst/ivsteditcontroller.h>
+
+#include <atomic>
+
+class EasyVst;
+
+// Host side of IComponentHandler. Edits from the controller are queued into the host's parameter queue
+// for the next process() call. Restart requests may arrive on any thread and are only recorded here;
+// EasyVst acts on them from the thread that calls its update methods.
+class EasyVstComponentHandler : public Steinberg::Vst::IComponentHandler {
+public:
+	EasyVstComponentHandler();
+	virtual ~EasyVstComponentHandler();
+
+	void setHost(EasyVst *host);
+
+	Steinberg::int32 pendingRestartFlags() const;
+	Steinberg::int32 takeRestartFlags(Steinberg::int32 mask);
+
+	Steinberg::tresult PLUGIN_API beginEdit(Steinberg::Vst::ParamID id) override;
+	Steinberg::tresult PLUGIN_API performEdit(Steinberg::Vst::ParamID id, Steinberg::Vst::ParamValue valueNormalized) override;
+	Steinberg::tresult PLUGIN_API endEdit(Steinberg::Vst::ParamID id) override;
+	Steinberg::tresult PLUGIN_API restartComponent(Steinberg::int32 flags) override;
+
+	DECLARE_FUNKNOWN_METHODS
+
+private:
+	EasyVst *_host = nullptr;
+	std::atomic<Steinberg::int32> _restartFlags{0};
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <EasyVst.h>
+
+#include <vector>
+
+// Aligns the outputs of parallel EasyVst instances by delaying every path to the largest latency in the
+// group. The delay lines are allocated in prepare() for maxCompensation samples; update() re-reads the
+// instances' latencies and only moves read positions, so it can run on the audio thread at block start.
+class EasyVstDelayCompensator {
+public:
+	EasyVstDelayCompensator();
+	~EasyVstDelayCompensator();
+
+	int addPath(EasyVst *vst, int numChannels);
+	void clear();
+
+	bool prepare(int maxCompensation);
+	bool update();
+
+	int numPaths() const;
+	int delay(int path) const;
+	int groupLatency() const;
+
+	void process(int path, Steinberg::Vst::Sample32 *const *channels, int numChannels, int numSamples);
+	void process(int path, Steinberg::Vst::Sample64 *const *channels, int numChannels, int numSamples);
+
+private:
+	struct Path {
+		EasyVst *vst = nullptr;
+		int numChannels = 0;
+		int delay = 0;
+		size_t writePosition = 0;
+		std::vector<std::vector<Steinberg::Vst::Sample64>> lines;
+	};
+
+	template <typename SampleType>
+	void _process(Path &path, SampleType *const *channels, int numChannels, int numSamples);
+
+	void _printError(const std::string &error);
+
+	std::vector<Path> _paths;
+	int _maxCompensation = 0;
+	int _groupLatency = 0;
+	size_t _mask = 0;
+};
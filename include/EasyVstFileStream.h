@@ -0,0 +1,118 @@
+#pragma once
+
+#include <EasyVst.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+enum class EasyVstFileContainer {
+	kRaw,
+	kWav
+};
+
+// Streams an interleaved WAV or raw file into an input bus straight from a read-only memory mapping. A
+// background thread keeps a window ahead of the read position resident with madvise() and drops the
+// pages behind it, so memory use stays constant however long the file is. A WAV data chunk whose size is
+// saturated (as EasyVstFileWriter leaves it beyond 4 GiB) or zero (an unfinished recording) is read to the
+// end of the file. Reading up to maxBlockFrames per block never allocates. Requires mmap().
+class EasyVstFileReader {
+public:
+	static constexpr size_t DEFAULT_PREFETCH_BYTES = 8 << 20;
+	static constexpr int DEFAULT_MAX_BLOCK_FRAMES = 8192;
+
+	EasyVstFileReader();
+	~EasyVstFileReader();
+
+	bool open(const std::string &path, size_t prefetchBytes = DEFAULT_PREFETCH_BYTES, int maxBlockFrames = DEFAULT_MAX_BLOCK_FRAMES);
+	bool openRaw(const std::string &path, EasyVstSampleFormat format, int channels, int sampleRate, size_t dataOffset = 0, size_t prefetchBytes = DEFAULT_PREFETCH_BYTES, int maxBlockFrames = DEFAULT_MAX_BLOCK_FRAMES);
+	void close();
+
+	bool isOpen() const;
+	Steinberg::int64 numFrames() const;
+	Steinberg::int64 position() const;
+	bool seek(Steinberg::int64 frame);
+
+	int channels() const;
+	int sampleRate() const;
+	EasyVstSampleFormat format() const;
+
+	// Fills numFrames of the input bus and returns how many came from the file; the rest is silence
+	int read(EasyVst &vst, int bus, int numFrames, float gain = 1.0f);
+
+private:
+	bool _map(const std::string &path);
+	bool _parseWav();
+	bool _startPrefetch(size_t prefetchBytes);
+	void _prefetchMain();
+
+	void _printError(const std::string &error);
+
+	std::string _path;
+	int _fd = -1;
+	const char *_mapping = nullptr;
+	size_t _mappingSize = 0;
+	size_t _dataOffset = 0, _dataSize = 0;
+
+	EasyVstSampleFormat _format = EasyVstSampleFormat::kFloat32;
+	int _channels = 0, _sampleRate = 0, _frameBytes = 0;
+	Steinberg::int64 _numFrames = 0;
+	std::atomic<Steinberg::int64> _position{0};
+	std::vector<char> _tail;
+
+	std::thread _prefetchThread;
+	std::mutex _prefetchMutex;
+	std::condition_variable _prefetchWake;
+	size_t _prefetchBytes = 0;
+	Steinberg::int64 _prefetchHalfWindow = 0;
+	bool _prefetchRunning = false;
+};
+
+// Collects interleaved output from an output bus into two buffers and writes each full buffer on a
+// background thread while the other one fills, so process() only waits when the disk falls a whole buffer
+// behind. WAV headers are patched on close(); beyond 4 GiB the sizes are saturated to 0xFFFFFFFF, which
+// EasyVstFileReader takes to mean "to the end of the file".
+class EasyVstFileWriter {
+public:
+	EasyVstFileWriter();
+	~EasyVstFileWriter();
+
+	bool open(const std::string &path, EasyVstFileContainer container, EasyVstSampleFormat format, int channels, int sampleRate, int bufferFrames = 65536);
+	bool close();
+
+	bool isOpen() const;
+	Steinberg::int64 framesWritten() const;
+
+	bool write(EasyVst &vst, int bus, int numFrames, float gain = 1.0f);
+
+private:
+	struct Buffer {
+		std::vector<char> data;
+		size_t used = 0;
+	};
+
+	bool _submit();
+	void _writerMain();
+	bool _writeWavHeader(Steinberg::uint64 dataBytes);
+
+	void _printError(const std::string &error);
+
+	std::FILE *_file = nullptr;
+	EasyVstFileContainer _container = EasyVstFileContainer::kRaw;
+	EasyVstSampleFormat _format = EasyVstSampleFormat::kFloat32;
+	int _channels = 0, _sampleRate = 0, _frameBytes = 0;
+	Steinberg::int64 _framesWritten = 0;
+
+	Buffer _buffers[2];
+	int _fillingBuffer = 0;
+
+	std::thread _writerThread;
+	std::mutex _writerMutex;
+	std::condition_variable _writerWake, _writerDone;
+	Buffer *_pendingBuffer = nullptr;
+	bool _writerRunning = false;
+	std::atomic<bool> _failed{false};
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <EasyVst.h>
+
+#include <vector>
+
+// Connects the audio and event buses of several EasyVst instances and processes them in dependency order.
+// Where a destination bus has a single compatible source, it reads directly from the source's output
+// buffers instead of receiving a copy. Buffers are bound in prepare(); call it again after any connected
+// instance is re-initialized or reconfigured. Until then processing fails for every node that reads from or
+// is such an instance.
+class EasyVstGraph {
+public:
+	EasyVstGraph();
+	~EasyVstGraph();
+
+	int addNode(EasyVst *vst);
+	bool connectAudio(int sourceNode, int sourceBus, int destNode, int destBus);
+	bool connectEvents(int sourceNode, int sourceBus, int destNode, int destBus);
+	void clear();
+
+	bool prepare();
+	bool process(int numSamples);
+	bool processNode(int index, int numSamples);
+	bool isPrepared() const;
+
+	int numNodes() const;
+	EasyVst *node(int index) const;
+	const std::vector<int> &successors(int index) const;
+	int numPredecessors(int index) const;
+	const std::vector<int> &processingOrder() const;
+
+private:
+	struct Connection {
+		int sourceNode = -1, sourceBus = -1;
+		int destNode = -1, destBus = -1;
+	};
+
+	struct AudioInput {
+		int destBus = -1;
+		std::vector<Connection> sources;
+		bool shared = false;
+	};
+
+	struct EventInput {
+		std::vector<Connection> sources;
+		bool shared = false;
+	};
+
+	struct Node {
+		EasyVst *vst = nullptr;
+		std::vector<AudioInput> audioInputs;
+		EventInput eventInput;
+		std::vector<int> successors;
+		int numPredecessors = 0;
+		Steinberg::uint32 bufferGeneration = 0;
+	};
+
+	void _unbind();
+	bool _sortNodes();
+	bool _isCurrent(const Node &node) const;
+	void _pullAudioInput(Node &node, AudioInput &input, int numSamples);
+	void _pullEvents(Node &node);
+
+	void _printError(const std::string &error);
+
+	std::vector<Node> _nodes;
+	std::vector<Connection> _audioConnections, _eventConnections;
+	std::vector<int> _order;
+	bool _prepared = false;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <EasyVst.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// One plugin to instantiate into a caller-owned EasyVst, which must outlive the load. done() runs on the
+// thread that performed the load. Plugins that only initialize correctly on the main thread are loaded by
+// runMainThreadTasks() or wait() instead of a worker, either per request or for every load of a path.
+struct EasyVstLoadRequest {
+	EasyVst *vst = nullptr;
+	std::string path;
+	std::string classIdOrName;
+	int sampleRate = 0;
+	int maxBlockSize = 0;
+	int symbolicSampleSize = Steinberg::Vst::kSample32;
+	bool realtime = true;
+	bool mainThread = false;
+
+	std::function<void(EasyVst &, bool)> done;
+};
+
+// Instantiates plugins in parallel on a bounded pool of worker threads, so loading a session takes about as
+// long as its slowest plugins rather than the sum of all of them.
+class EasyVstLoader {
+public:
+	EasyVstLoader();
+	~EasyVstLoader();
+
+	bool start(int numThreads);
+	void stop();
+
+	void pinToMainThread(const std::string &path);
+	std::future<bool> submit(EasyVstLoadRequest request);
+
+	int runMainThreadTasks();
+	void wait();
+
+private:
+	void _workerMain();
+
+	void _printError(const std::string &error);
+
+	std::vector<std::thread> _workers;
+
+	std::mutex _mutex;
+	std::condition_variable _taskAvailable, _progress;
+	std::deque<std::packaged_task<bool()>> _tasks, _mainThreadTasks;
+	std::unordered_set<std::string> _mainThreadPaths;
+	int _pendingTasks = 0;
+	bool _running = false;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <pluginterfaces/base/funknown.h>
+
+#include <atomic>
+
+struct EasyVstProcessStats {
+	Steinberg::uint64 calls = 0;
+	Steinberg::uint64 failures = 0;
+	Steinberg::uint64 overruns = 0;
+
+	Steinberg::int64 minNs = 0;
+	Steinberg::int64 p50Ns = 0;
+	Steinberg::int64 p99Ns = 0;
+	Steinberg::int64 maxNs = 0;
+
+	double lastLoad = 0.0;
+	double peakLoad = 0.0;
+	double averageLoad = 0.0;
+};
+
+// Per-instance process() timings, written by the audio thread and readable from any thread without locks.
+// Durations go into a log-linear histogram with eight buckets per power of two, so percentiles are
+// reported as bucket upper bounds within 12.5% of the true value. Load is process time over the block
+// deadline; a call that exceeds its deadline counts as an overrun.
+class EasyVstMetrics {
+public:
+	EasyVstMetrics();
+
+	void record(Steinberg::int64 durationNs, Steinberg::int64 deadlineNs, bool failed);
+	void reset();
+
+	EasyVstProcessStats stats() const;
+
+private:
+	static const int NUM_LINEAR_BUCKETS = 16;
+	static const int SUB_BUCKETS = 8;
+	static const int MAX_EXPONENT = 40;
+	static const int NUM_BUCKETS = NUM_LINEAR_BUCKETS + (MAX_EXPONENT - 4 + 1) * SUB_BUCKETS;
+
+	static int _bucketIndex(Steinberg::int64 durationNs);
+	static Steinberg::int64 _bucketUpperBound(int index);
+	void _clear();
+
+	std::atomic<Steinberg::uint64> _buckets[NUM_BUCKETS];
+	std::atomic<Steinberg::uint64> _calls{0}, _failures{0}, _overruns{0};
+	std::atomic<Steinberg::int64> _minNs{0}, _maxNs{0};
+	std::atomic<Steinberg::int64> _totalNs{0}, _totalDeadlineNs{0};
+	std::atomic<double> _lastLoad{0.0}, _peakLoad{0.0};
+	std::atomic<bool> _resetRequested{false};
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <pluginterfaces/vst/ivsteditcontroller.h>
+
+#include <string>
+#include <vector>
+
+struct EasyVstParameter {
+	enum class Conversion {
+		kController,
+		kLinear,
+		kStepped
+	};
+
+	Steinberg::Vst::ParamID id = 0;
+	std::string title;
+	std::string shortTitle;
+	std::string units;
+	Steinberg::int32 stepCount = 0;
+	Steinberg::Vst::ParamValue defaultNormalizedValue = 0.0;
+	Steinberg::Vst::UnitID unitId = 0;
+	Steinberg::int32 flags = 0;
+
+	Conversion conversion = Conversion::kController;
+	Steinberg::Vst::ParamValue minPlain = 0.0;
+	Steinberg::Vst::ParamValue maxPlain = 1.0;
+
+	bool canAutomate() const;
+	bool isReadOnly() const;
+	bool isBypass() const;
+	bool isList() const;
+	bool isProgramChange() const;
+};
+
+// Parameter metadata read once from an edit controller, with open-addressing lookup by ID and by title.
+// At build time each parameter's normalized <-> plain mapping is sampled; when it matches the linear or
+// stepped formula used by the SDK's standard parameters, conversions are done here instead of through the
+// controller. Everything else falls back to the controller. Immutable once built, so instances of one
+// class can share it between threads.
+class EasyVstParameterIndex {
+public:
+	EasyVstParameterIndex();
+	~EasyVstParameterIndex();
+
+	bool build(Steinberg::Vst::IEditController *controller);
+
+	int count() const;
+	const EasyVstParameter &at(int index) const;
+	const EasyVstParameter *find(Steinberg::Vst::ParamID id) const;
+	const EasyVstParameter *find(const std::string &title) const;
+
+	Steinberg::Vst::ParamValue toPlain(const EasyVstParameter &parameter, Steinberg::Vst::ParamValue normalized, Steinberg::Vst::IEditController *controller) const;
+	Steinberg::Vst::ParamValue toNormalized(const EasyVstParameter &parameter, Steinberg::Vst::ParamValue plain, Steinberg::Vst::IEditController *controller) const;
+
+private:
+	static EasyVstParameter::Conversion _detectConversion(Steinberg::Vst::IEditController *controller, const EasyVstParameter &parameter);
+	static Steinberg::Vst::ParamValue _formulaToPlain(const EasyVstParameter &parameter, EasyVstParameter::Conversion conversion, Steinberg::Vst::ParamValue normalized);
+	static Steinberg::Vst::ParamValue _formulaToNormalized(const EasyVstParameter &parameter, Steinberg::Vst::ParamValue plain);
+
+	static size_t _hash(Steinberg::Vst::ParamID id);
+	static size_t _hash(const std::string &title);
+
+	void _printError(const std::string &error) const;
+
+	std::vector<EasyVstParameter> _parameters;
+	std::vector<int> _idSlots, _titleSlots;
+	size_t _mask = 0;
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <EasyVst.h>
+
+// Runs two instances of one plugin so that presets can change without reinitializing. prepareSwap() loads a
+// state into the standby instance on a control thread while the active one keeps processing; the audio
+// thread picks the swap up in beginBlock() and carries the process context, sample position and any queued
+// parameter changes over. Only use the instance returned by beginBlock() for the rest of the block, and queue
+// parameter changes on active().
+class EasyVstPresetSwap {
+public:
+	EasyVstPresetSwap();
+	~EasyVstPresetSwap();
+
+	bool init(const std::string &path, const std::string &classIdOrName, int sampleRate, int maxBlockSize, int symbolicSampleSize, bool realtime);
+	void destroy();
+	void setProcessing(bool processing);
+
+	bool prepareSwap(EasyVstState &state);
+	bool swapPending() const;
+
+	EasyVst *beginBlock();
+	EasyVst *active();
+	EasyVst *standby();
+
+private:
+	void _printError(const std::string &error);
+
+	EasyVst _instances[2];
+	std::atomic<int> _active{0};
+	std::atomic<bool> _swapPending{false};
+};
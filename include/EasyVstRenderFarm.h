@@ -0,0 +1,83 @@
+#pragma once
+
+#include <EasyVst.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// One offline render: the plugin to use, an optional preset, and caller-owned planar buffers for the main
+// input and output bus. Only the buffers matching the farm's sample size are used; each is either empty or
+// holds one channel per channel of that bus, otherwise the job fails. Outputs must hold totalFrames +
+// maxTailFrames samples per channel, with a negative maxTailFrames rendering the plugin's whole tail (see
+// EasyVst::renderOffline()). prepare() runs on the worker before rendering and may schedule events or
+// parameter changes at sample positions counted from the start of the job.
+struct EasyVstRenderJob {
+	std::string path;
+	std::string classIdOrName;
+	std::shared_ptr<const EasyVstState> state;
+	std::function<void(EasyVst &)> prepare;
+
+	std::vector<const Steinberg::Vst::Sample32 *> inputs32;
+	std::vector<Steinberg::Vst::Sample32 *> outputs32;
+	std::vector<const Steinberg::Vst::Sample64 *> inputs64;
+	std::vector<Steinberg::Vst::Sample64 *> outputs64;
+	Steinberg::int64 totalFrames = 0;
+	Steinberg::int64 maxTailFrames = -1;
+
+	std::function<void(const EasyVstRenderJob &, bool)> done;
+};
+
+// Renders queued jobs on a pool of worker threads. Each worker keeps its own initialized instance per
+// plugin and resets it between jobs, so a plugin is only loaded once per worker for the whole batch.
+class EasyVstRenderFarm {
+public:
+	EasyVstRenderFarm();
+	~EasyVstRenderFarm();
+
+	void preload(const std::string &path, const std::string &classIdOrName);
+	bool start(int numThreads, int sampleRate, int maxBlockSize, int symbolicSampleSize);
+	void stop();
+
+	void submit(EasyVstRenderJob job);
+	void wait();
+
+	Steinberg::uint64 completedJobs() const;
+	Steinberg::uint64 failedJobs() const;
+
+private:
+	struct Instance {
+		EasyVst vst;
+		EasyVstState defaultState, jobState;
+		bool hasDefaultState = false;
+		bool used = false;
+	};
+
+	struct Worker {
+		std::thread thread;
+		std::unordered_map<std::string, std::unique_ptr<Instance>> instances;
+	};
+
+	void _workerMain(Worker *worker);
+	Instance *_instance(Worker &worker, const std::string &path, const std::string &classIdOrName);
+	bool _render(Worker &worker, const EasyVstRenderJob &job);
+
+	void _printError(const std::string &error);
+
+	std::vector<std::unique_ptr<Worker>> _workers;
+	std::vector<std::pair<std::string, std::string>> _preloads;
+
+	std::mutex _mutex;
+	std::condition_variable _jobAvailable, _idle;
+	std::deque<EasyVstRenderJob> _jobs;
+	int _activeJobs = 0;
+	bool _running = false;
+
+	int _sampleRate = 0, _maxBlockSize = 0, _symbolicSampleSize = 0;
+	std::atomic<Steinberg::uint64> _completedJobs{0}, _failedJobs{0};
+};
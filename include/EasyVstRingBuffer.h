@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bounded lock-free queue with storage allocated up front by reset(). Any number of threads may
+// push and pop concurrently; push() fails instead of allocating when the queue is full.
+template <typename T>
+class EasyVstRingBuffer {
+public:
+	EasyVstRingBuffer()
+	{}
+
+	explicit EasyVstRingBuffer(size_t capacity)
+	{
+		reset(capacity);
+	}
+
+	// Not thread-safe; call while no other thread is using the queue
+	void reset(size_t capacity)
+	{
+		size_t size = 1;
+		while (size < capacity) {
+			size <<= 1;
+		}
+
+		_cells.reset(new Cell[size]);
+		for (size_t i = 0; i < size; ++i) {
+			_cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		_mask = size - 1;
+		_enqueuePos.store(0, std::memory_order_relaxed);
+		_dequeuePos.store(0, std::memory_order_relaxed);
+	}
+
+	bool push(const T &item)
+	{
+		if (!_cells) {
+			return false;
+		}
+
+		size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+		while (true) {
+			Cell &cell = _cells[pos & _mask];
+			size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+			if (diff == 0) {
+				if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					cell.data = item;
+					cell.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (diff < 0) {
+				return false;
+			} else {
+				pos = _enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	bool pop(T &item)
+	{
+		if (!_cells) {
+			return false;
+		}
+
+		size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+		while (true) {
+			Cell &cell = _cells[pos & _mask];
+			size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+			if (diff == 0) {
+				if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					item = cell.data;
+					cell.sequence.store(pos + _mask + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (diff < 0) {
+				return false;
+			} else {
+				pos = _dequeuePos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	size_t capacity() const
+	{
+		return _cells ? _mask + 1 : 0;
+	}
+
+private:
+	struct Cell {
+		std::atomic<size_t> sequence;
+		T data;
+	};
+
+	std::unique_ptr<Cell[]> _cells;
+	size_t _mask = 0;
+	alignas(64) std::atomic<size_t> _enqueuePos{0};
+	alignas(64) std::atomic<size_t> _dequeuePos{0};
+};
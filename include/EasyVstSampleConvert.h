@@ -0,0 +1,27 @@
+#pragma once
+
+#include <pluginterfaces/vst/ivstaudioprocessor.h>
+
+enum class EasyVstSampleFormat {
+	kFloat32,
+	kInt16,
+	kInt24,
+	kInt32
+};
+
+// Planar <-> interleaved copies and sample size conversion. Stereo float32/int16 and Sample32 <-> Sample64
+// paths use SSE2, AVX2 or NEON when the compiler targets them; everything else runs scalar loops that
+// walk one channel at a time. Integer formats scale by 2^(n-1) both ways, so integer data converts to float
+// and back bit-exactly at unity gain. Only the first numChannels slots of each interleaved frame of frameChannels samples are touched.
+namespace EasyVstSampleConvert {
+int bytesPerSample(EasyVstSampleFormat format);
+
+void interleave(const Steinberg::Vst::Sample32 *const *planar, int numChannels, void *interleaved, int frameChannels, EasyVstSampleFormat format, int numFrames, float gain);
+void interleave(const Steinberg::Vst::Sample64 *const *planar, int numChannels, void *interleaved, int frameChannels, EasyVstSampleFormat format, int numFrames, float gain);
+
+void deinterleave(const void *interleaved, int frameChannels, EasyVstSampleFormat format, Steinberg::Vst::Sample32 *const *planar, int numChannels, int numFrames, float gain);
+void deinterleave(const void *interleaved, int frameChannels, EasyVstSampleFormat format, Steinberg::Vst::Sample64 *const *planar, int numChannels, int numFrames, float gain);
+
+void convert(const Steinberg::Vst::Sample32 *source, Steinberg::Vst::Sample64 *dest, int numSamples, double gain);
+void convert(const Steinberg::Vst::Sample64 *source, Steinberg::Vst::Sample32 *dest, int numSamples, double gain);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <pluginterfaces/vst/ivstaudioprocessor.h>
+
+#include <string>
+#include <vector>
+
+class EasyVst;
+struct EasyVstSandboxControl;
+
+// Hosts a plugin in a helper process for EasyVst::initSandboxed(). The helper is the easyvst-sandbox-host
+// executable (tools/EasyVstSandboxHost.cpp), spawned fresh rather than forked from the host so that it does
+// not inherit locks held by other host threads; it looks next to the host executable unless setHelperPath()
+// says otherwise. Audio buffers, events, parameter changes and the process context live in a shared memory
+// region; each block is handed over with a futex wakeup in each direction, after a short spin so that a busy
+// child answers without entering the kernel. Only available on Linux.
+class EasyVstSandbox {
+public:
+	EasyVstSandbox();
+	~EasyVstSandbox();
+
+	bool start(EasyVst &host);
+	void stop();
+
+	Steinberg::tresult process(EasyVst &host);
+	bool setProcessing(bool processing);
+	bool setBusActive(Steinberg::Vst::MediaType type, Steinberg::Vst::BusDirection direction, int which, bool active);
+
+	bool crashed() const;
+
+	static void setHelperPath(const std::string &path);
+	static int runChild(int fd, size_t initialSize, int parentPid);
+
+private:
+	static std::string _defaultHelperPath();
+
+	bool _request(Steinberg::uint32 command, int timeoutMs);
+	bool _awaitResponse(Steinberg::uint32 lastResponse, int timeoutMs);
+	bool _reapChild();
+	bool _mapRegion(size_t size);
+	void _kill();
+
+	int _fd = -1;
+	int _pid = -1;
+	void *_region = nullptr;
+	size_t _regionSize = 0;
+	EasyVstSandboxControl *_control = nullptr;
+	bool _crashed = false;
+
+	static std::string _helperPath;
+
+	std::vector<Steinberg::Vst::AudioBusBuffers> _busBuffers[2];
+	std::vector<std::vector<Steinberg::Vst::Sample32 *>> _channels32[2];
+	std::vector<std::vector<Steinberg::Vst::Sample64 *>> _channels64[2];
+};
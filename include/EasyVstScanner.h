@@ -0,0 +1,68 @@
+#pragma once
+
+#include <EasyVst.h>
+
+#include <string>
+#include <vector>
+
+struct EasyVstBusLayout {
+	std::string name;
+	Steinberg::int32 mediaType = 0;
+	Steinberg::int32 direction = 0;
+	Steinberg::int32 channelCount = 0;
+	Steinberg::int32 busType = 0;
+	Steinberg::uint32 flags = 0;
+	Steinberg::Vst::SpeakerArrangement speakerArrangement = 0;
+};
+
+struct EasyVstClassRecord {
+	std::string uid;
+	std::string name;
+	std::string category;
+	std::string subCategories;
+	std::string vendor;
+	std::string version;
+	std::string sdkVersion;
+
+	bool probed = false;
+	bool supports64Bit = false;
+	Steinberg::uint32 latencySamples = 0;
+	Steinberg::uint32 tailSamples = 0;
+	Steinberg::uint32 processContextRequirements = 0;
+	std::vector<EasyVstBusLayout> buses;
+};
+
+struct EasyVstPluginRecord {
+	std::string path;
+	Steinberg::int64 modifiedTime = 0;
+	Steinberg::uint64 fingerprint = 0;
+	// Set when the module could not be loaded; error holds the reason
+	bool loadFailed = false;
+	std::string error;
+	std::vector<EasyVstClassRecord> classes;
+};
+
+// Keeps a catalogue of installed VST3 bundles and their class, bus and processing details in a compact
+// binary cache file. scan() only loads modules whose path, modification time or file fingerprint changed.
+// Bundles that fail to load are kept with loadFailed set, so they are not retried until they change.
+class EasyVstScanner {
+public:
+	EasyVstScanner();
+	~EasyVstScanner();
+
+	bool loadCache(const std::string &cachePath);
+	bool saveCache(const std::string &cachePath) const;
+
+	int scan();
+	int scan(const std::vector<std::string> &bundlePaths);
+
+	const std::vector<EasyVstPluginRecord> &plugins() const;
+	const EasyVstPluginRecord *find(const std::string &path) const;
+
+private:
+	bool _probe(const std::string &path, EasyVstPluginRecord &record);
+
+	void _printError(const std::string &path, const std::string &error);
+
+	std::vector<EasyVstPluginRecord> _plugins;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <EasyVstGraph.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct EasyVstCycleStats {
+	Steinberg::int64 wallTimeNs = 0;
+	Steinberg::int64 criticalPathNs = 0;
+	Steinberg::int64 totalWorkNs = 0;
+	int numNodes = 0;
+};
+
+// Runs the nodes of a prepared EasyVstGraph in parallel. Ready nodes are pushed onto per-thread
+// Chase-Lev deques and idle threads steal from each other; the thread calling process() takes part
+// as worker 0 and returns after a single barrier once every node has run.
+class EasyVstScheduler {
+public:
+	EasyVstScheduler();
+	~EasyVstScheduler();
+
+	bool start(EasyVstGraph *graph, int numThreads, bool pinThreads);
+	void stop();
+
+	bool process(int numSamples);
+	const EasyVstCycleStats &cycleStats() const;
+
+private:
+	class WorkDeque {
+	public:
+		void allocate(int capacity);
+		void clear();
+		void push(int node);
+		int pop();
+		int steal();
+
+	private:
+		std::vector<std::atomic<int>> _buffer;
+		Steinberg::int64 _mask = 0;
+		alignas(64) std::atomic<Steinberg::int64> _top{0};
+		alignas(64) std::atomic<Steinberg::int64> _bottom{0};
+	};
+
+	void _workerMain(int index, bool pin, Steinberg::uint64 startCycle);
+	void _runCycle(int index);
+	void _runNode(int index, int node);
+	void _computeStats(Steinberg::int64 wallTimeNs);
+
+	void _printError(const std::string &error);
+
+	EasyVstGraph *_graph = nullptr;
+	std::vector<std::thread> _threads;
+	std::vector<std::unique_ptr<WorkDeque>> _deques;
+	std::unique_ptr<std::atomic<int>[]> _pending;
+	std::vector<Steinberg::int64> _nodeDurationNs, _pathNs;
+
+	std::mutex _wakeMutex;
+	std::condition_variable _wakeCondition;
+	std::atomic<Steinberg::uint64> _cycle{0};
+	std::atomic<bool> _running{false};
+
+	std::atomic<int> _remainingNodes{0};
+	std::atomic<int> _workersInCycle{0};
+	std::atomic<bool> _failed{false};
+	int _numSamples = 0;
+
+	EasyVstCycleStats _stats;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <pluginterfaces/base/ibstream.h>
+
+#include <vector>
+
+// IBStream over a growable byte buffer. rewind() and clear() keep the allocation, so one stream can be
+// written and read back repeatedly without touching the heap once it has reached its working size.
+class EasyVstMemoryStream : public Steinberg::IBStream {
+public:
+	EasyVstMemoryStream();
+	virtual ~EasyVstMemoryStream();
+
+	void reserve(size_t size);
+	void rewind();
+	void clear();
+
+	const char *data() const;
+	void assign(const void *data, size_t size);
+	size_t size() const;
+
+	Steinberg::tresult PLUGIN_API read(void *buffer, Steinberg::int32 numBytes, Steinberg::int32 *numBytesRead = nullptr) override;
+	Steinberg::tresult PLUGIN_API write(void *buffer, Steinberg::int32 numBytes, Steinberg::int32 *numBytesWritten = nullptr) override;
+	Steinberg::tresult PLUGIN_API seek(Steinberg::int64 pos, Steinberg::int32 mode, Steinberg::int64 *result = nullptr) override;
+	Steinberg::tresult PLUGIN_API tell(Steinberg::int64 *pos) override;
+
+	DECLARE_FUNKNOWN_METHODS
+
+private:
+	std::vector<char> _data;
+	size_t _size = 0;
+	size_t _cursor = 0;
+};
+
+// Component and controller state of one plugin instance, as written by EasyVst::saveState()
+struct EasyVstState {
+	EasyVstMemoryStream component;
+	EasyVstMemoryStream controller;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <EasyVstRingBuffer.h>
+
+#include <pluginterfaces/base/funknown.h>
+
+#include <atomic>
+#include <string>
+
+struct EasyVstTraceSpan {
+	static const int MAX_INSTANCE_NAME = 48;
+
+	const char *name = nullptr;
+	char instance[MAX_INSTANCE_NAME] = {};
+	Steinberg::int64 startNs = 0;
+	Steinberg::int64 endNs = 0;
+	Steinberg::int32 blockSize = -1;
+};
+
+// Timeline of hosting activity for chrome://tracing or ui.perfetto.dev. Each thread records spans into
+// its own preallocated lock-free queue; a background thread drains them into a Chrome trace JSON file
+// until stop(). Spans are compiled in only with EASYVST_TRACING defined and cost one atomic load while
+// tracing is stopped. A thread's first span allocates its queue unless registerThread() ran beforehand.
+class EasyVstTrace {
+public:
+	class Scope {
+	public:
+		Scope(const char *name, const std::string &instance, Steinberg::int32 blockSize = -1);
+		~Scope();
+
+	private:
+		const char *_name;
+		char _instance[EasyVstTraceSpan::MAX_INSTANCE_NAME];
+		Steinberg::int32 _blockSize;
+		Steinberg::int64 _startNs = 0;
+	};
+
+	static bool start(const std::string &path, int capacityPerThread = 65536, int flushIntervalMs = 100);
+	static void stop();
+	static bool isEnabled();
+
+	static void registerThread();
+	static void record(const char *name, const char *instance, Steinberg::int32 blockSize, Steinberg::int64 startNs, Steinberg::int64 endNs);
+	static Steinberg::uint64 droppedSpans();
+
+	static Steinberg::int64 nowNs();
+
+private:
+	static std::atomic<bool> _enabled;
+};
+
+#ifdef EASYVST_TRACING
+#define EASYVST_TRACE_CONCAT_INNER(a, b) a##b
+#define EASYVST_TRACE_CONCAT(a, b) EASYVST_TRACE_CONCAT_INNER(a, b)
+#define EASYVST_TRACE_SCOPE(name, instance, blockSize) EasyVstTrace::Scope EASYVST_TRACE_CONCAT(easyVstTraceScope, __LINE__)(name, instance, blockSize)
+#else
+#define EASYVST_TRACE_SCOPE(name, instance, blockSize) ((void) 0)
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <pluginterfaces/vst/ivstaudioprocessor.h>
+#include <pluginterfaces/vst/ivstprocesscontext.h>
+
+#include <atomic>
+
+// Musical transport shared by any number of EasyVst instances through EasyVst::setTransport(). Positions
+// advance incrementally by advance(), which is called once per audio cycle after every instance sharing the
+// transport has processed that cycle; each instance then copies only the fields its plugin asked for through
+// IProcessContextRequirements. Setters and advance() belong to the audio thread or to times when nothing
+// is processing. Musical positions assume the current tempo applies from the relocated position onwards.
+class EasyVstTransport {
+public:
+	EasyVstTransport();
+	~EasyVstTransport();
+
+	void setSampleRate(double sampleRate);
+	void setTempo(double tempo);
+	void setTimeSignature(Steinberg::int32 numerator, Steinberg::int32 denominator);
+	void setCycle(bool active, Steinberg::Vst::TQuarterNotes start, Steinberg::Vst::TQuarterNotes end);
+	void setPlaying(bool playing);
+	void setRecording(bool recording);
+	void setPosition(Steinberg::int64 projectTimeSamples);
+
+	void advance(int numSamples);
+
+	void addRequirements(Steinberg::uint32 requirements);
+	void fill(Steinberg::Vst::ProcessContext &context, Steinberg::uint32 requirements) const;
+	const Steinberg::Vst::ProcessContext &context() const;
+
+private:
+	void _updateRates();
+	void _updateBarPosition();
+	void _updateClock();
+	void _updateSystemTime();
+
+	Steinberg::Vst::ProcessContext _context = {};
+	double _quarterNotesPerSample = 0.0;
+	double _quarterNotesPerBar = 4.0;
+	std::atomic<Steinberg::uint32> _requirements{0};
+};
@@ -1,11 +1,63 @@
 #include <EasyVst.h>
+#include <EasyVstSandbox.h>
 
 Steinberg::Vst::HostApplication *EasyVst::_standardPluginContext = nullptr;
-int EasyVst::_standardPluginContextRefCount = 0;
+std::atomic<int> EasyVst::_standardPluginContextRefCount{0};
+std::mutex EasyVst::_pluginContextMutex;
+std::mutex EasyVst::_moduleCacheMutex;
+std::unordered_map<std::string, std::weak_ptr<VST3::Hosting::Module>> EasyVst::_moduleCache;
+std::mutex EasyVst::_parameterIndexCacheMutex;
+std::unordered_map<std::string, std::weak_ptr<const EasyVstParameterIndex>> EasyVst::_parameterIndexCache;
 
 using namespace Steinberg;
 using namespace Steinberg::Vst;
 
+static const int MIN_QUEUED_PARAMETERS = 64;
+static const int RESERVED_POINTS_PER_PARAMETER = 32;
+// What the owned buffers provide and plugins commonly assume for aligned SIMD loads
+static const uintptr_t EXTERNAL_BUFFER_ALIGNMENT = 16;
+
+template <typename SampleType>
+static SampleType **busChannels(AudioBusBuffers &bus);
+
+template <>
+Sample32 **busChannels<Sample32>(AudioBusBuffers &bus)
+{
+	return bus.channelBuffers32;
+}
+
+template <>
+Sample64 **busChannels<Sample64>(AudioBusBuffers &bus)
+{
+	return bus.channelBuffers64;
+}
+
+static uint64 allChannelsMask(int numChannels)
+{
+	return numChannels >= 64 ? ~uint64(0) : (uint64(1) << numChannels) - 1;
+}
+
+template <typename SampleType>
+static uint64 silentChannels(SampleType **channels, int numChannels, int numSamples)
+{
+	uint64 flags = 0;
+	for (int i = 0; i < std::min(numChannels, 64); ++i) {
+		const SampleType *samples = channels[i];
+		if (std::all_of(samples, samples + numSamples, [](SampleType sample) { return sample == SampleType(0); })) {
+			flags |= uint64(1) << i;
+		}
+	}
+	return flags;
+}
+
+static uint64 silentChannels(AudioBusBuffers &bus, int symbolicSampleSize, int numSamples)
+{
+	if (symbolicSampleSize == kSample64) {
+		return silentChannels(bus.channelBuffers64, bus.numChannels, numSamples);
+	}
+	return silentChannels(bus.channelBuffers32, bus.numChannels, numSamples);
+}
+
 EasyVst::EasyVst()
 {}
 
@@ -16,158 +68,390 @@ EasyVst::~EasyVst()
 
 bool EasyVst::init(const std::string &path, int sampleRate, int maxBlockSize, int symbolicSampleSize, bool realtime)
 {
-	_destroy(false);
+	return init(path, "", sampleRate, maxBlockSize, symbolicSampleSize, realtime);
+}
 
-	++_standardPluginContextRefCount;
-	if (!_standardPluginContext) {
-		_standardPluginContext = owned(NEW HostApplication());
-		PluginContextFactory::instance().setPluginContext(_standardPluginContext);
-	}
+bool EasyVst::init(const std::string &path, const std::string &classIdOrName, int sampleRate, int maxBlockSize, int symbolicSampleSize, bool realtime)
+{
+	EASYVST_TRACE_SCOPE("EasyVst::init", path, maxBlockSize);
 
-	_path = path;
-	_sampleRate = sampleRate;
-	_maxBlockSize = maxBlockSize;
-	_symbolicSampleSize = symbolicSampleSize;
-	_realtime = realtime;
+	_destroy(false);
 
-	_processSetup.processMode = _realtime;
-	_processSetup.symbolicSampleSize = _symbolicSampleSize;
-	_processSetup.sampleRate = _sampleRate;
-	_processSetup.maxSamplesPerBlock = _maxBlockSize;
+	if (!_holdsPluginContext) {
+		_acquirePluginContext();
+		_holdsPluginContext = true;
+	}
 
-	_processData.numSamples = 0;
-	_processData.symbolicSampleSize = _symbolicSampleSize;
-	_processData.processContext = &_processContext;
+	_configure(path, sampleRate, maxBlockSize, symbolicSampleSize, realtime);
 
 	std::string error;
-	_module = VST3::Hosting::Module::create(path, error);
+	_module = _loadModule(path, error);
 	if (!_module) {
 		_printError(error);
 		return false;
 	}
 
 	VST3::Hosting::PluginFactory factory = _module->getFactory();
-	for (auto &classInfo : factory.classInfos()) {
-		if (classInfo.category() == kVstAudioEffectClass) {
-			_plugProvider = owned(NEW PlugProvider(factory, classInfo, true));
-			if (!_plugProvider) {
-				_printError("No PlugProvider found");
-				return false;
-			}
+	auto classInfos = factory.classInfos();
+	auto classId = VST3::UID::fromString(classIdOrName);
+	const VST3::Hosting::ClassInfo *selectedClass = nullptr;
+	for (auto &classInfo : classInfos) {
+		if (classInfo.category() != kVstAudioEffectClass) {
+			continue;
+		}
+		if (classIdOrName.empty() || classInfo.name() == classIdOrName || (classId && classInfo.ID() == *classId)) {
+			selectedClass = &classInfo;
+			break;
+		}
+	}
 
-			_vstPlug = _plugProvider->getComponent();
+	if (!selectedClass) {
+		_printError(classIdOrName.empty() ? "No audio effect class found" : "No audio effect class matches \"" + classIdOrName + "\"");
+		return false;
+	}
 
-			_audioEffect = FUnknownPtr<IAudioProcessor>(_vstPlug);
-			if (!_audioEffect) {
-				_printError("Could not get audio processor from VST");
-				return false;
-			}
+	_plugProvider = owned(NEW PlugProvider(factory, *selectedClass, true));
+	if (!_plugProvider) {
+		_printError("No PlugProvider found");
+		return false;
+	}
+
+	_vstPlug = _plugProvider->getComponent();
+
+	_audioEffect = FUnknownPtr<IAudioProcessor>(_vstPlug);
+	if (!_audioEffect) {
+		_printError("Could not get audio processor from VST");
+		return false;
+	}
 
-			_editController = _plugProvider->getController();
+	_editController = _plugProvider->getController();
+	if (_editController) {
+		_componentHandler.setHost(this);
+		_editController->setComponentHandler(&_componentHandler);
+
+		std::atomic_store(&_parameterIndex, _loadParameterIndex(path + "|" + selectedClass->ID().toString(), _editController));
+	}
+	_prepareParameterChanges();
 
-			_name = classInfo.name();
+	_name = selectedClass->name();
 
-			FUnknownPtr<IProcessContextRequirements> contextRequirements(_audioEffect);
-			if (contextRequirements) {
-				auto flags = contextRequirements->getProcessContextRequirements();
+	FUnknownPtr<IProcessContextRequirements> contextRequirements(_audioEffect);
+	if (contextRequirements) {
+		auto flags = contextRequirements->getProcessContextRequirements();
+		_contextRequirements = flags;
 
 #define PRINT_FLAG(x) if (flags & IProcessContextRequirements::Flags::x) { _printDebug(#x); }
-				PRINT_FLAG(kNeedSystemTime)
-					PRINT_FLAG(kNeedContinousTimeSamples)
-					PRINT_FLAG(kNeedProjectTimeMusic)
-					PRINT_FLAG(kNeedBarPositionMusic)
-					PRINT_FLAG(kNeedCycleMusic)
-					PRINT_FLAG(kNeedSamplesToNextClock)
-					PRINT_FLAG(kNeedTempo)
-					PRINT_FLAG(kNeedTimeSignature)
-					PRINT_FLAG(kNeedChord)
-					PRINT_FLAG(kNeedFrameRate)
-					PRINT_FLAG(kNeedTransportState)
+		PRINT_FLAG(kNeedSystemTime)
+			PRINT_FLAG(kNeedContinousTimeSamples)
+			PRINT_FLAG(kNeedProjectTimeMusic)
+			PRINT_FLAG(kNeedBarPositionMusic)
+			PRINT_FLAG(kNeedCycleMusic)
+			PRINT_FLAG(kNeedSamplesToNextClock)
+			PRINT_FLAG(kNeedTempo)
+			PRINT_FLAG(kNeedTimeSignature)
+			PRINT_FLAG(kNeedChord)
+			PRINT_FLAG(kNeedFrameRate)
+			PRINT_FLAG(kNeedTransportState)
 #undef PRINT_FLAG
-			}
+	}
+	if (_transport) {
+		_transport->addRequirements(_contextRequirements);
+	}
 
-			_numInAudioBuses = _vstPlug->getBusCount(MediaTypes::kAudio, BusDirections::kInput);
-			_numOutAudioBuses = _vstPlug->getBusCount(MediaTypes::kAudio, BusDirections::kOutput);
-			_numInEventBuses = _vstPlug->getBusCount(MediaTypes::kEvent, BusDirections::kInput);
-			_numOutEventBuses = _vstPlug->getBusCount(MediaTypes::kEvent, BusDirections::kOutput);
-
-			std::ostringstream debugOss;
-			debugOss << "Buses: " << _numInAudioBuses << " audio and " << _numInEventBuses << " event inputs; ";
-			debugOss << _numOutAudioBuses << " audio and " << _numOutEventBuses << " event outputs";
-			_printDebug(debugOss.str());
-
-			for (int i = 0; i < _numInAudioBuses; ++i) {
-				BusInfo info;
-				_vstPlug->getBusInfo(kAudio, kInput, i, info);
-				_inAudioBusInfos.push_back(info);
-				setBusActive(kAudio, kInput, i, false);
-
-				SpeakerArrangement speakerArr;
-				_audioEffect->getBusArrangement(kInput, i, speakerArr);
-				_inSpeakerArrs.push_back(speakerArr);
-			}
+	_numInAudioBuses = _vstPlug->getBusCount(MediaTypes::kAudio, BusDirections::kInput);
+	_numOutAudioBuses = _vstPlug->getBusCount(MediaTypes::kAudio, BusDirections::kOutput);
+	_numInEventBuses = _vstPlug->getBusCount(MediaTypes::kEvent, BusDirections::kInput);
+	_numOutEventBuses = _vstPlug->getBusCount(MediaTypes::kEvent, BusDirections::kOutput);
+
+	std::ostringstream debugOss;
+	debugOss << "Buses: " << _numInAudioBuses << " audio and " << _numInEventBuses << " event inputs; ";
+	debugOss << _numOutAudioBuses << " audio and " << _numOutEventBuses << " event outputs";
+	_printDebug(debugOss.str());
+
+	for (int i = 0; i < _numInAudioBuses; ++i) {
+		BusInfo info;
+		_vstPlug->getBusInfo(kAudio, kInput, i, info);
+		_inAudioBusInfos.push_back(info);
+		setBusActive(kAudio, kInput, i, false);
+
+		SpeakerArrangement speakerArr;
+		_audioEffect->getBusArrangement(kInput, i, speakerArr);
+		_inSpeakerArrs.push_back(speakerArr);
+	}
 
-			for (int i = 0; i < _numInEventBuses; ++i) {
-				BusInfo info;
-				_vstPlug->getBusInfo(kEvent, kInput, i, info);
-				_inEventBusInfos.push_back(info);
-				setBusActive(kEvent, kInput, i, false);
-			}
+	for (int i = 0; i < _numInEventBuses; ++i) {
+		BusInfo info;
+		_vstPlug->getBusInfo(kEvent, kInput, i, info);
+		_inEventBusInfos.push_back(info);
+		setBusActive(kEvent, kInput, i, false);
+	}
 
-			for (int i = 0; i < _numOutAudioBuses; ++i) {
-				BusInfo info;
-				_vstPlug->getBusInfo(kAudio, kOutput, i, info);
-				_outAudioBusInfos.push_back(info);
-				setBusActive(kAudio, kOutput, i, false);
+	for (int i = 0; i < _numOutAudioBuses; ++i) {
+		BusInfo info;
+		_vstPlug->getBusInfo(kAudio, kOutput, i, info);
+		_outAudioBusInfos.push_back(info);
+		setBusActive(kAudio, kOutput, i, false);
 
-				SpeakerArrangement speakerArr;
-				_audioEffect->getBusArrangement(kOutput, i, speakerArr);
-				_outSpeakerArrs.push_back(speakerArr);
-			}
+		SpeakerArrangement speakerArr;
+		_audioEffect->getBusArrangement(kOutput, i, speakerArr);
+		_outSpeakerArrs.push_back(speakerArr);
+	}
 
-			for (int i = 0; i < _numOutEventBuses; ++i) {
-				BusInfo info;
-				_vstPlug->getBusInfo(kEvent, kOutput, i, info);
-				_outEventBusInfos.push_back(info);
-				setBusActive(kEvent, kOutput, i, false);
-			}
+	for (int i = 0; i < _numOutEventBuses; ++i) {
+		BusInfo info;
+		_vstPlug->getBusInfo(kEvent, kOutput, i, info);
+		_outEventBusInfos.push_back(info);
+		setBusActive(kEvent, kOutput, i, false);
+	}
 
-			tresult res = _audioEffect->setBusArrangements(_inSpeakerArrs.data(), _numInAudioBuses, _outSpeakerArrs.data(), _numOutAudioBuses);
-			if (res != kResultTrue) {
-				_printError("Failed to set bus arrangements");
-				return false;
-			}
+	tresult res = _audioEffect->setBusArrangements(_inSpeakerArrs.data(), _numInAudioBuses, _outSpeakerArrs.data(), _numOutAudioBuses);
+	if (res != kResultTrue) {
+		_printError("Failed to set bus arrangements");
+		return false;
+	}
 
-			res = _audioEffect->setupProcessing(_processSetup);
-			if (res == kResultOk) {
-				_processData.prepare(*_vstPlug, _maxBlockSize, _processSetup.symbolicSampleSize);
-				if (_numInEventBuses > 0) {
-					_processData.inputEvents = new EventList[_numInEventBuses];
-				}
-				if (_numOutEventBuses > 0) {
-					_processData.outputEvents = new EventList[_numOutEventBuses];
-				}
-			} else {
-				_printError("Failed to setup VST processing");
-				return false;
+	if (_audioEffect->canProcessSampleSize(_symbolicSampleSize) != kResultTrue) {
+		int32 fallbackSampleSize = _symbolicSampleSize == kSample32 ? kSample64 : kSample32;
+		if (_audioEffect->canProcessSampleSize(fallbackSampleSize) != kResultTrue) {
+			_printError("VST does not support any sample size");
+			return false;
+		}
+
+		_printDebug("Requested sample size is not supported, converting buffers");
+		_convertSampleSize = true;
+		_processSetup.symbolicSampleSize = fallbackSampleSize;
+		_processData.symbolicSampleSize = fallbackSampleSize;
+	}
+
+	res = _audioEffect->setupProcessing(_processSetup);
+	if (res == kResultOk) {
+		_activeArena = _arena;
+		if (!_prepareBuffers(_processSetup.symbolicSampleSize)) {
+			return false;
+		}
+		_snapshotChannelBuffers();
+		if (!_prepareEventScheduler()) {
+			return false;
+		}
+	} else {
+		_printError("Failed to setup VST processing");
+		return false;
+	}
+
+	if (_vstPlug->setActive(true) != kResultTrue) {
+		_printError("Failed to activate VST component");
+		return false;
+	}
+	_latencySamples.store(_audioEffect->getLatencySamples(), std::memory_order_release);
+
+	return true;
+}
+
+bool EasyVst::initSandboxed(const std::string &path, int sampleRate, int maxBlockSize, int symbolicSampleSize, bool realtime)
+{
+	EASYVST_TRACE_SCOPE("EasyVst::initSandboxed", path, maxBlockSize);
+
+	_destroy(false);
+
+	if (!_holdsPluginContext) {
+		_acquirePluginContext();
+		_holdsPluginContext = true;
+	}
+
+	_configure(path, sampleRate, maxBlockSize, symbolicSampleSize, realtime);
+
+	_sandbox = new EasyVstSandbox();
+	if (!_sandbox->start(*this)) {
+		return false;
+	}
+
+	_prepareParameterChanges();
+	_snapshotChannelBuffers();
+	if (!_prepareEventScheduler()) {
+		return false;
+	}
+
+	return true;
+}
+
+std::future<bool> EasyVst::initAsync(const std::string &path, const std::string &classIdOrName, int sampleRate, int maxBlockSize, int symbolicSampleSize, bool realtime, std::function<void(EasyVst &, bool)> done)
+{
+	// A std::async future would block in its destructor, turning a discarded result into a synchronous load
+	auto result = std::make_shared<std::promise<bool>>();
+	std::future<bool> future = result->get_future();
+	std::thread([this, path, classIdOrName, sampleRate, maxBlockSize, symbolicSampleSize, realtime, done, result] {
+		bool success = init(path, classIdOrName, sampleRate, maxBlockSize, symbolicSampleSize, realtime);
+		if (done) {
+			done(*this, success);
+		}
+		result->set_value(success);
+	}).detach();
+	return future;
+}
+
+void EasyVst::setArena(std::shared_ptr<EasyVstArena> arena)
+{
+	// Channels kept from an earlier init belong to the previous arena; an active one keeps its own until destroyed
+	if (arena != _arena && !_activeArena) {
+		_arenaChannels.clear();
+	}
+	_arena = arena;
+}
+
+void EasyVst::setTransport(std::shared_ptr<EasyVstTransport> transport)
+{
+	_transport = transport;
+	if (_transport && (_audioEffect || _sandbox)) {
+		_transport->addRequirements(_contextRequirements);
+	}
+}
+
+Steinberg::uint32 EasyVst::processContextRequirements() const
+{
+	return _contextRequirements;
+}
+
+bool EasyVst::reconfigure(int sampleRate, int maxBlockSize, int symbolicSampleSize, bool realtime)
+{
+	if (!_audioEffect) {
+		_printError("Cannot reconfigure an uninitialized or sandboxed VST");
+		return false;
+	}
+
+	bool wasProcessing = _processing;
+	if (wasProcessing) {
+		setProcessing(false);
+	}
+	_vstPlug->setActive(false);
+
+	int32 pluginSampleSize = symbolicSampleSize;
+	bool convertSampleSize = false;
+	if (_audioEffect->canProcessSampleSize(symbolicSampleSize) != kResultTrue) {
+		pluginSampleSize = symbolicSampleSize == kSample32 ? kSample64 : kSample32;
+		convertSampleSize = true;
+	}
+
+	ProcessSetup setup = _processSetup;
+	setup.processMode = realtime ? kRealtime : kOffline;
+	setup.symbolicSampleSize = pluginSampleSize;
+	setup.sampleRate = sampleRate;
+	setup.maxSamplesPerBlock = maxBlockSize;
+	if ((convertSampleSize && _audioEffect->canProcessSampleSize(pluginSampleSize) != kResultTrue) || _audioEffect->setupProcessing(setup) != kResultOk) {
+		_printError("Failed to setup VST processing for new configuration, keeping the previous one");
+		_audioEffect->setupProcessing(_processSetup);
+		_vstPlug->setActive(true);
+		if (wasProcessing) {
+			setProcessing(true);
+		}
+		return false;
+	}
+
+	// Buffers (and any buses bound to external ones) are kept when they are large enough already
+	++_bufferGeneration;
+	bool reuseBuffers = maxBlockSize <= _preparedBlockSize && pluginSampleSize == _processSetup.symbolicSampleSize && convertSampleSize == _convertSampleSize;
+
+	ProcessSetup previousSetup = _processSetup;
+	int previousSampleRate = _sampleRate, previousMaxBlockSize = _maxBlockSize, previousSymbolicSampleSize = _symbolicSampleSize;
+	bool previousRealtime = _realtime, previousConvertSampleSize = _convertSampleSize;
+	auto restorePrevious = [&]() {
+		_printError("Restoring the previous configuration");
+		_sampleRate = previousSampleRate;
+		_maxBlockSize = previousMaxBlockSize;
+		_symbolicSampleSize = previousSymbolicSampleSize;
+		_realtime = previousRealtime;
+		_processSetup = previousSetup;
+		_processData.processMode = previousSetup.processMode;
+		_processContext.sampleRate = previousSampleRate;
+		_audioEffect->setupProcessing(previousSetup);
+
+		if (!reuseBuffers) {
+			_processData.unprepare();
+			_hostBuffers.unprepare();
+			_convertSampleSize = previousConvertSampleSize;
+			if (!_prepareBuffers(previousSetup.symbolicSampleSize)) {
+				_printError("Failed to restore the previous process buffers");
+				return;
 			}
+			_snapshotChannelBuffers();
+		}
+		_processData.symbolicSampleSize = previousSetup.symbolicSampleSize;
 
-			if (_vstPlug->setActive(true) != kResultTrue) {
-				_printError("Failed to activate VST component");
-				return false;
+		_vstPlug->setActive(true);
+		if (wasProcessing) {
+			setProcessing(true);
+		}
+	};
+
+	_sampleRate = sampleRate;
+	_maxBlockSize = maxBlockSize;
+	_symbolicSampleSize = symbolicSampleSize;
+	_realtime = realtime;
+	_processSetup = setup;
+	_processData.processMode = setup.processMode;
+	_processContext.sampleRate = sampleRate;
+
+	if (!reuseBuffers) {
+		_restoreChannelBuffers();
+		_processData.unprepare();
+		_hostBuffers.unprepare();
+		_convertSampleSize = convertSampleSize;
+		if (!_prepareBuffers(pluginSampleSize)) {
+			restorePrevious();
+			return false;
+		}
+		_snapshotChannelBuffers();
+	} else {
+		// Persistent bindings made for a smaller maximum block size cannot hold the new one
+		for (int direction = kInput; direction <= kOutput; ++direction) {
+			for (int i = 0; i < static_cast<int>(_bindingCapacity[direction].size()); ++i) {
+				if (_bindingCapacity[direction][i] > 0 && _bindingCapacity[direction][i] < maxBlockSize) {
+					_unbindAudioBus(direction, i);
+					_printError("External buffers bound to bus " + std::to_string(i) + " are smaller than the new maximum block size and were unbound");
+				}
 			}
 		}
 	}
+	_processData.symbolicSampleSize = pluginSampleSize;
+
+	if (_vstPlug->setActive(true) != kResultTrue) {
+		_printError("Failed to reactivate VST component");
+		_vstPlug->setActive(false);
+		restorePrevious();
+		return false;
+	}
+	_latencySamples.store(_audioEffect->getLatencySamples(), std::memory_order_release);
+
+	if (wasProcessing) {
+		setProcessing(true);
+	}
 
 	return true;
 }
 
+bool EasyVst::sandboxCrashed() const
+{
+	return _sandbox && _sandbox->crashed();
+}
+
 void EasyVst::destroy()
 {
+	EASYVST_TRACE_SCOPE("EasyVst::destroy", _name, -1);
+
 	_destroy(true);
 }
 
 bool EasyVst::process(int numSamples)
+{
+	EASYVST_TRACE_SCOPE("EasyVst::process", _name, numSamples);
+
+	bool result = _process(numSamples);
+	if (!_oneShotBindings.empty()) {
+		_releaseOneShotBindings();
+	}
+	return result;
+}
+
+bool EasyVst::_process(int numSamples)
 {
 	if (numSamples > _maxBlockSize) {
 #ifdef _DEBUG
@@ -176,8 +460,51 @@ bool EasyVst::process(int numSamples)
 		numSamples = _maxBlockSize;
 	}
 
+	for (int i = 0; i < _numOutEventBuses && _outEventLists; ++i) {
+		_outEventLists[i].clear();
+	}
+	_processData.inputEvents = _sharedInputEvents ? _sharedInputEvents : _inEventLists;
+
+	bool inputSilent = _updateInputSilence(numSamples);
+
+	_outParameterChanges.clearQueue();
+	_drainParameterQueue(numSamples);
+	_drainEventQueue(numSamples);
+	_mergeInputEventBuses();
+
+	if (_canSkipBlock(inputSilent, numSamples)) {
+		_skipBlock(numSamples);
+		return true;
+	}
+
+	if (_convertSampleSize) {
+		_convertBuses(kInput, numSamples);
+	}
+	for (int i = 0; i < _processData.numOutputs; ++i) {
+		_processData.outputs[i].silenceFlags = 0;
+	}
+
+	if (_transport) {
+		_transport->fill(_processContext, _contextRequirements);
+		_processContext.sampleRate = _processSetup.sampleRate;
+	}
+
 	_processData.numSamples = numSamples;
-	tresult result = _audioEffect->process(_processData);
+	int64 startNs = hostTimeNs();
+	tresult result;
+	if (_sandbox) {
+		result = _sandbox->process(*this);
+	} else {
+		EASYVST_TRACE_SCOPE("IAudioProcessor::process", _name, numSamples);
+		_audit.begin(_samplePosition.load(std::memory_order_relaxed));
+		result = _audioEffect->process(_processData);
+		_audit.end();
+	}
+	int64 deadlineNs = static_cast<int64>(numSamples * 1e9 / _processSetup.sampleRate);
+	_metrics.record(hostTimeNs() - startNs, deadlineNs, result != kResultOk);
+	for (int i = 0; i < _numInEventBuses && _inEventLists; ++i) {
+		_inEventLists[i].clear();
+	}
 	if (result != kResultOk) {
 #ifdef _DEBUG
 		std::cerr << "VST process failed" << std::endl;
@@ -185,9 +512,30 @@ bool EasyVst::process(int numSamples)
 		return false;
 	}
 
+	_drainOutputParameterChanges();
+
+	if (_convertSampleSize) {
+		_convertBuses(kOutput, numSamples);
+	}
+	if (_silencePolicy.load(std::memory_order_relaxed) == EasyVstSilencePolicy::kSkipWhenSilent) {
+		_outputSilent = _updateOutputSilence(numSamples);
+	}
+
+	_samplePosition.fetch_add(numSamples, std::memory_order_relaxed);
+
 	return true;
 }
 
+bool EasyVst::renderOffline(const Sample32 *const *inputs, Sample32 *const *outputs, int64 totalFrames, int64 maxTailFrames)
+{
+	return _renderOffline(inputs, outputs, totalFrames, maxTailFrames);
+}
+
+bool EasyVst::renderOffline(const Sample64 *const *inputs, Sample64 *const *outputs, int64 totalFrames, int64 maxTailFrames)
+{
+	return _renderOffline(inputs, outputs, totalFrames, maxTailFrames);
+}
+
 const Steinberg::Vst::BusInfo *EasyVst::busInfo(Steinberg::Vst::MediaType type, Steinberg::Vst::BusDirection direction, int which)
 {
 	if (type == kAudio) {
@@ -234,87 +582,532 @@ int EasyVst::numBuses(Steinberg::Vst::MediaType type, Steinberg::Vst::BusDirecti
 	}
 }
 
+int EasyVst::numChannels(BusDirection direction, int which)
+{
+	int numBusBuffers = direction == kInput ? _processData.numInputs : (direction == kOutput ? _processData.numOutputs : 0);
+	if (which < 0 || which >= numBusBuffers) {
+		return 0;
+	}
+	return _hostBuses(direction)[which].numChannels;
+}
+
 void EasyVst::setBusActive(MediaType type, BusDirection direction, int which, bool active)
 {
+	if (_sandbox) {
+		_sandbox->setBusActive(type, direction, which, active);
+		return;
+	}
+
 	_vstPlug->activateBus(type, direction, which, active);
 }
 
 void EasyVst::setProcessing(bool processing)
 {
-	_audioEffect->setProcessing(processing);
+	EASYVST_TRACE_SCOPE(processing ? "EasyVst::setProcessing(true)" : "EasyVst::setProcessing(false)", _name, -1);
+
+	if (_sandbox) {
+		_sandbox->setProcessing(processing);
+	} else {
+		_audioEffect->setProcessing(processing);
+	}
+	_processing = processing;
 }
 
-Steinberg::Vst::ProcessContext *EasyVst::processContext()
+bool EasyVst::reset()
 {
-	return &_processContext;
+	if (!_vstPlug && !_sandbox) {
+		_printError("Cannot reset an uninitialized VST");
+		return false;
+	}
+
+	bool wasProcessing = _processing;
+	if (wasProcessing) {
+		setProcessing(false);
+	}
+	if (!_sandbox) {
+		_vstPlug->setActive(false);
+	}
+
+	ParameterChangePoint change;
+	while (_parameterQueue.pop(change)) {
+	}
+	_pendingParameterChanges.clear();
+	_inParameterChanges.clearQueue();
+	_outParameterChanges.clearQueue();
+
+	ScheduledEvent event;
+	while (_eventQueue.pop(event)) {
+	}
+	_pendingEvents.clear();
+	_dueEvents.clear();
+	for (int i = 0; i < _numInEventBuses && _inEventLists; ++i) {
+		_inEventLists[i].clear();
+	}
+	for (int i = 0; i < _numOutEventBuses && _outEventLists; ++i) {
+		_outEventLists[i].clear();
+	}
+
+	_processContext = {};
+	_samplePosition.store(0, std::memory_order_relaxed);
+	_silentInputSamples = 0;
+	_outputSilent = false;
+
+	if (!_sandbox && _vstPlug->setActive(true) != kResultTrue) {
+		_printError("Failed to reactivate VST component");
+		return false;
+	}
+	if (wasProcessing) {
+		setProcessing(true);
+	}
+
+	return true;
 }
 
-Steinberg::Vst::Sample32 *EasyVst::channelBuffer32(BusDirection direction, int which)
+void EasyVst::setSilencePolicy(EasyVstSilencePolicy policy)
 {
-	if (direction == kInput) {
-		return _processData.inputs->channelBuffers32[which];
-	} else if (direction == kOutput) {
-		return _processData.outputs->channelBuffers32[which];
-	} else {
-		return nullptr;
-	}
+	_silencePolicy.store(policy, std::memory_order_relaxed);
 }
 
-Steinberg::Vst::Sample64 *EasyVst::channelBuffer64(BusDirection direction, int which)
+EasyVstSilencePolicy EasyVst::silencePolicy() const
 {
-	if (direction == kInput) {
-		return _processData.inputs->channelBuffers64[which];
-	} else if (direction == kOutput) {
-		return _processData.outputs->channelBuffers64[which];
-	} else {
-		return nullptr;
-	}
+	return _silencePolicy.load(std::memory_order_relaxed);
 }
 
-Steinberg::Vst::EventList *EasyVst::eventList(Steinberg::Vst::BusDirection direction, int which)
+Steinberg::uint64 EasyVst::skippedBlocks() const
 {
-	if (direction == kInput) {
-		return static_cast<Steinberg::Vst::EventList *>(&_processData.inputEvents[which]);
-	} else if (direction == kOutput) {
-		return static_cast<Steinberg::Vst::EventList *>(&_processData.outputEvents[which]);
-	} else {
-		return nullptr;
-	}
+	return _skippedBlocks.load(std::memory_order_relaxed);
 }
 
-Steinberg::Vst::ParameterChanges *EasyVst::parameterChanges(Steinberg::Vst::BusDirection direction, int which)
+std::shared_ptr<const EasyVstParameterIndex> EasyVst::parameterIndex() const
 {
-	if (direction == kInput) {
-		return static_cast<Steinberg::Vst::ParameterChanges *>(&_processData.inputParameterChanges[which]);
-	} else if (direction == kOutput) {
-		return static_cast<Steinberg::Vst::ParameterChanges *>(&_processData.outputParameterChanges[which]);
-	} else {
-		return nullptr;
-	}
+	return std::atomic_load(&_parameterIndex);
 }
 
-bool EasyVst::createView()
+bool EasyVst::updateParameterIndex()
 {
-	if (!_editController) {
-		_printError("VST does not provide an edit controller");
+	if (!_editController || !_componentHandler.takeRestartFlags(kParamTitlesChanged)) {
 		return false;
 	}
 
-	if (_view || _window) {
-		_printDebug("Editor view or window already exists");
+	// The new metadata belongs to this instance only, so it is not written back to the shared cache
+	auto index = std::make_shared<EasyVstParameterIndex>();
+	if (!index->build(_editController)) {
+		_printError("Failed to rebuild parameter index");
 		return false;
 	}
 
-	_view = _editController->createView(ViewType::kEditor);
-	if (!_view) {
-		_printError("EditController does not provide its own view");
-		return false;
-	}
+	std::atomic_store(&_parameterIndex, std::shared_ptr<const EasyVstParameterIndex>(std::move(index)));
+	return true;
+}
 
-	ViewRect viewRect = {};
-	if (_view->getSize(&viewRect) != kResultOk) {
-		_printError("Failed to get editor view size");
-		return false;
+ParamValue EasyVst::normalizedToPlain(ParamID id, ParamValue normalizedValue)
+{
+	auto index = parameterIndex();
+	const EasyVstParameter *parameter = index ? index->find(id) : nullptr;
+	if (parameter) {
+		return index->toPlain(*parameter, normalizedValue, _editController);
+	}
+
+	return _editController ? _editController->normalizedParamToPlain(id, normalizedValue) : normalizedValue;
+}
+
+ParamValue EasyVst::plainToNormalized(ParamID id, ParamValue plainValue)
+{
+	auto index = parameterIndex();
+	const EasyVstParameter *parameter = index ? index->find(id) : nullptr;
+	if (parameter) {
+		return index->toNormalized(*parameter, plainValue, _editController);
+	}
+
+	return _editController ? _editController->plainParamToNormalized(id, plainValue) : plainValue;
+}
+
+Steinberg::int64 EasyVst::tailSamples()
+{
+	if (!_audioEffect) {
+		return 0;
+	}
+
+	int64 maxTail = static_cast<int64>(MAX_TAIL_SECONDS) * _sampleRate;
+	uint32 tail = _audioEffect->getTailSamples();
+	return tail == kInfiniteTail ? maxTail : std::min<int64>(tail, maxTail);
+}
+
+Steinberg::uint32 EasyVst::latencySamples() const
+{
+	return _latencySamples.load(std::memory_order_acquire);
+}
+
+bool EasyVst::latencyChangePending() const
+{
+	return (_componentHandler.pendingRestartFlags() & kLatencyChanged) != 0;
+}
+
+bool EasyVst::updateLatency()
+{
+	if (!_audioEffect) {
+		return false;
+	}
+	// Restarting the component under a running process() would race with it, so the change stays pending
+	if (_processing) {
+		_printError("updateLatency() called while processing");
+		return false;
+	}
+	if (!_componentHandler.takeRestartFlags(kLatencyChanged)) {
+		return false;
+	}
+
+	_vstPlug->setActive(false);
+
+	uint32 latency = _audioEffect->getLatencySamples();
+
+	if (_vstPlug->setActive(true) != kResultTrue) {
+		_printError("Failed to reactivate VST component after latency change");
+	}
+
+	return _latencySamples.exchange(latency, std::memory_order_acq_rel) != latency;
+}
+
+Steinberg::Vst::ProcessContext *EasyVst::processContext()
+{
+	return &_processContext;
+}
+
+Steinberg::Vst::Sample32 *EasyVst::channelBuffer32(BusDirection direction, int which)
+{
+	if (direction == kInput || direction == kOutput) {
+		return _hostBuses(direction)->channelBuffers32[which];
+	} else {
+		return nullptr;
+	}
+}
+
+Steinberg::Vst::Sample64 *EasyVst::channelBuffer64(BusDirection direction, int which)
+{
+	if (direction == kInput || direction == kOutput) {
+		return _hostBuses(direction)->channelBuffers64[which];
+	} else {
+		return nullptr;
+	}
+}
+
+bool EasyVst::bindBuffers(BusDirection direction, int which, Sample32 *const *channelBuffers, int numChannels, int capacityFrames, bool persistent)
+{
+	return _bindBuffers(direction, which, channelBuffers, numChannels, capacityFrames, persistent);
+}
+
+bool EasyVst::bindBuffers(BusDirection direction, int which, Sample64 *const *channelBuffers, int numChannels, int capacityFrames, bool persistent)
+{
+	return _bindBuffers(direction, which, channelBuffers, numChannels, capacityFrames, persistent);
+}
+
+void EasyVst::unbindBuffers(BusDirection direction, int which)
+{
+	if ((direction == kInput || direction == kOutput) && which >= 0 && which < static_cast<int>(_ownedChannelBuffers[direction].size()) && !(direction == kInput && _graphInputs[which])) {
+		_unbindAudioBus(direction, which);
+	}
+}
+
+bool EasyVst::copyFromInterleaved(int bus, const void *interleaved, EasyVstSampleFormat format, int frameChannels, int numFrames, float gain)
+{
+	if (bus < 0 || bus >= _processData.numInputs || numFrames > _maxBlockSize) {
+		_printError("Invalid interleaved input copy");
+		return false;
+	}
+
+	AudioBusBuffers &busBuffers = _hostBuses(kInput)[bus];
+	int numChannels = std::min(busBuffers.numChannels, frameChannels);
+	if (_symbolicSampleSize == kSample64) {
+		EasyVstSampleConvert::deinterleave(interleaved, frameChannels, format, busBuffers.channelBuffers64, numChannels, numFrames, gain);
+		for (int i = numChannels; i < busBuffers.numChannels; ++i) {
+			std::fill(busBuffers.channelBuffers64[i], busBuffers.channelBuffers64[i] + numFrames, 0.0);
+		}
+	} else {
+		EasyVstSampleConvert::deinterleave(interleaved, frameChannels, format, busBuffers.channelBuffers32, numChannels, numFrames, gain);
+		for (int i = numChannels; i < busBuffers.numChannels; ++i) {
+			std::fill(busBuffers.channelBuffers32[i], busBuffers.channelBuffers32[i] + numFrames, 0.0f);
+		}
+	}
+
+	return true;
+}
+
+bool EasyVst::copyToInterleaved(int bus, void *interleaved, EasyVstSampleFormat format, int frameChannels, int numFrames, float gain)
+{
+	if (bus < 0 || bus >= _processData.numOutputs || numFrames > _maxBlockSize) {
+		_printError("Invalid interleaved output copy");
+		return false;
+	}
+
+	AudioBusBuffers &busBuffers = _hostBuses(kOutput)[bus];
+	int numChannels = std::min(busBuffers.numChannels, frameChannels);
+	if (numChannels < frameChannels) {
+		std::memset(interleaved, 0, static_cast<size_t>(numFrames) * frameChannels * EasyVstSampleConvert::bytesPerSample(format));
+	}
+
+	if (_symbolicSampleSize == kSample64) {
+		EasyVstSampleConvert::interleave(busBuffers.channelBuffers64, numChannels, interleaved, frameChannels, format, numFrames, gain);
+	} else {
+		EasyVstSampleConvert::interleave(busBuffers.channelBuffers32, numChannels, interleaved, frameChannels, format, numFrames, gain);
+	}
+
+	return true;
+}
+
+bool EasyVst::isConvertingSampleSize() const
+{
+	return _convertSampleSize;
+}
+
+Steinberg::Vst::EventList *EasyVst::eventList(Steinberg::Vst::BusDirection direction, int which)
+{
+	if (direction == kInput) {
+		return &_inEventLists[which];
+	} else if (direction == kOutput) {
+		return &_outEventLists[which];
+	} else {
+		return nullptr;
+	}
+}
+
+Steinberg::Vst::ParameterChanges *EasyVst::parameterChanges(Steinberg::Vst::BusDirection direction, int which)
+{
+	// Parameter changes belong to the component rather than to a bus, so there is one list per direction
+	if (which != 0) {
+		_printError("Parameter change list " + std::to_string(which) + " does not exist");
+		return nullptr;
+	}
+
+	if (direction == kInput) {
+		return &_inParameterChanges;
+	} else if (direction == kOutput) {
+		return &_outParameterChanges;
+	} else {
+		return nullptr;
+	}
+}
+
+void EasyVst::setParameterQueueCapacity(int capacity)
+{
+	_parameterQueueCapacity = std::max(capacity, 1);
+}
+
+bool EasyVst::queueParameterChange(ParamID id, ParamValue normalizedValue, int64 samplePosition)
+{
+	ParameterChangePoint change;
+	change.id = id;
+	change.value = normalizedValue;
+	change.samplePosition = samplePosition;
+	if (!_parameterQueue.push(change)) {
+		_parameterQueueOverflows.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	return true;
+}
+
+int EasyVst::applyOutputParameterChanges()
+{
+	int count = 0;
+	ParameterChangePoint change;
+	while (_outputParameterQueue.pop(change)) {
+		if (_editController) {
+			_editController->setParamNormalized(change.id, change.value);
+		}
+		++count;
+	}
+	return count;
+}
+
+Steinberg::uint64 EasyVst::parameterQueueOverflows() const
+{
+	return _parameterQueueOverflows.load(std::memory_order_relaxed);
+}
+
+Steinberg::uint64 EasyVst::outputParameterQueueOverflows() const
+{
+	return _outputParameterQueueOverflows.load(std::memory_order_relaxed);
+}
+
+Steinberg::int64 EasyVst::samplePosition() const
+{
+	return _samplePosition.load(std::memory_order_relaxed);
+}
+
+void EasyVst::setEventCapacity(int capacity)
+{
+	_eventCapacity = std::max(capacity, 1);
+}
+
+bool EasyVst::scheduleEvent(const Event &event, int64 samplePosition)
+{
+	if (event.busIndex < 0 || event.busIndex >= _numInEventBuses) {
+		_printError("Cannot schedule an event for nonexistent event bus " + std::to_string(event.busIndex));
+		return false;
+	}
+
+	ScheduledEvent scheduled;
+	scheduled.event = event;
+	scheduled.time = samplePosition;
+	if (!_eventQueue.push(scheduled)) {
+		_eventOverflows.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	return true;
+}
+
+bool EasyVst::scheduleEventAtTime(const Event &event, int64 hostTimeNs)
+{
+	if (event.busIndex < 0 || event.busIndex >= _numInEventBuses) {
+		_printError("Cannot schedule an event for nonexistent event bus " + std::to_string(event.busIndex));
+		return false;
+	}
+
+	ScheduledEvent scheduled;
+	scheduled.event = event;
+	scheduled.time = hostTimeNs;
+	scheduled.isHostTime = true;
+	if (!_eventQueue.push(scheduled)) {
+		_eventOverflows.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	return true;
+}
+
+Steinberg::uint64 EasyVst::eventOverflows() const
+{
+	return _eventOverflows.load(std::memory_order_relaxed);
+}
+
+Steinberg::int64 EasyVst::hostTimeNs()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+EasyVstProcessStats EasyVst::processStats() const
+{
+	return _metrics.stats();
+}
+
+void EasyVst::resetProcessStats()
+{
+	_metrics.reset();
+}
+
+bool EasyVst::setAuditEnabled(bool enabled, int capacity)
+{
+	if (!enabled) {
+		_audit.disable();
+		return true;
+	}
+
+	if (!EasyVstAudit::isAvailable()) {
+		_printError("Real-time audit requires a Linux build with EASYVST_AUDIT defined");
+		return false;
+	}
+	if (_sandbox) {
+		_printError("Real-time audit is not available for sandboxed VSTs");
+		return false;
+	}
+
+	return _audit.enable(capacity);
+}
+
+int EasyVst::collectAuditRecords(std::vector<EasyVstAuditRecord> &records)
+{
+	return _audit.collect(records);
+}
+
+Steinberg::uint64 EasyVst::auditOverflows() const
+{
+	return _audit.overflows();
+}
+
+bool EasyVst::saveState(EasyVstState &state)
+{
+	if (!_vstPlug) {
+		_printError("Cannot save state of an uninitialized VST");
+		return false;
+	}
+	if (_sandbox) {
+		_printError("State is not available for sandboxed VSTs");
+		return false;
+	}
+
+	state.component.clear();
+	if (_vstPlug->getState(&state.component) != kResultTrue) {
+		_printError("Failed to get component state");
+		return false;
+	}
+
+	state.controller.clear();
+	if (_editController && _editController->getState(&state.controller) != kResultTrue) {
+		state.controller.clear();
+	}
+
+	return true;
+}
+
+bool EasyVst::loadState(EasyVstState &state)
+{
+	if (!_vstPlug) {
+		_printError("Cannot load state into an uninitialized VST");
+		return false;
+	}
+	if (_sandbox) {
+		_printError("State is not available for sandboxed VSTs");
+		return false;
+	}
+
+	state.component.rewind();
+	if (_vstPlug->setState(&state.component) != kResultTrue) {
+		_printError("Failed to set component state");
+		return false;
+	}
+
+	if (_editController) {
+		state.component.rewind();
+		_editController->setComponentState(&state.component);
+
+		if (state.controller.size() > 0) {
+			state.controller.rewind();
+			if (_editController->setState(&state.controller) != kResultTrue) {
+				_printError("Failed to set controller state");
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool EasyVst::createView()
+{
+	EASYVST_TRACE_SCOPE("EasyVst::createView", _name, -1);
+
+#ifdef EASYVST_HEADLESS
+	_printError("Editor views are not available in headless builds");
+	return false;
+#else
+	if (!_editController) {
+		_printError("VST does not provide an edit controller");
+		return false;
+	}
+
+	if (_view || _window) {
+		_printDebug("Editor view or window already exists");
+		return false;
+	}
+
+	_view = _editController->createView(ViewType::kEditor);
+	if (!_view) {
+		_printError("EditController does not provide its own view");
+		return false;
+	}
+
+	ViewRect viewRect = {};
+	if (_view->getSize(&viewRect) != kResultOk) {
+		_printError("Failed to get editor view size");
+		return false;
 	}
 
 #ifdef _WIN32
@@ -342,20 +1135,24 @@ bool EasyVst::createView()
 #endif
 
 	return true;
+#endif
 	}
 
 void EasyVst::destroyView()
 {
+#ifndef EASYVST_HEADLESS
 	if (_window) {
 		SDL_DestroyWindow(_window);
 		_window = nullptr;
 	}
+#endif
 
 	if (_view) {
 		_view = nullptr;
 	}
 }
 
+#ifndef EASYVST_HEADLESS
 void EasyVst::processSdlEvent(const SDL_Event &event)
 {
 	if (event.type == SDL_WINDOWEVENT) {
@@ -368,6 +1165,7 @@ void EasyVst::processSdlEvent(const SDL_Event &event)
 		}
 	}
 }
+#endif
 
 const std::string &EasyVst::name()
 {
@@ -378,12 +1176,23 @@ void EasyVst::_destroy(bool decrementRefCount)
 {
 	destroyView();
 
+	if (_editController) {
+		_editController->setComponentHandler(nullptr);
+	}
+	_componentHandler.takeRestartFlags(~0);
+	_latencySamples.store(0, std::memory_order_release);
+	std::atomic_store(&_parameterIndex, std::shared_ptr<const EasyVstParameterIndex>());
+
 	_editController = nullptr;
 	_audioEffect = nullptr;
 	_vstPlug = nullptr;
 	_plugProvider = nullptr;
 	_module = nullptr;
 
+	_destroyEventLists(_inEventLists, _numInEventBuses);
+	_sharedInputEvents = nullptr;
+	_destroyEventLists(_outEventLists, _numOutEventBuses);
+
 	_inAudioBusInfos.clear();
 	_outAudioBusInfos.clear();
 	_numInAudioBuses = 0;
@@ -397,37 +1206,970 @@ void EasyVst::_destroy(bool decrementRefCount)
 	_inSpeakerArrs.clear();
 	_outSpeakerArrs.clear();
 
-	if (_processData.inputEvents) {
-		delete[] static_cast<Steinberg::Vst::EventList *>(_processData.inputEvents);
-	}
-	if (_processData.outputEvents) {
-		delete[] static_cast<Steinberg::Vst::EventList *>(_processData.outputEvents);
+	_restoreChannelBuffers();
+	_oneShotBindings.clear();
+	_ownedChannelBuffers[kInput].clear();
+	_ownedChannelBuffers[kOutput].clear();
+	_bindingCapacity[kInput].clear();
+	_bindingCapacity[kOutput].clear();
+	_graphInputs.clear();
+	if (_sandbox) {
+		// The sandbox owns the bus buffer arrays that point into its shared memory
+		_processData.inputs = nullptr;
+		_processData.outputs = nullptr;
+		_processData.numInputs = 0;
+		_processData.numOutputs = 0;
+		delete _sandbox;
+		_sandbox = nullptr;
 	}
 	_processData.unprepare();
 	_processData = {};
+	_hostBuffers.unprepare();
+	_convertSampleSize = false;
+	// A re-init with the same arena places its channels in the ones it already took from it
+	if (decrementRefCount || _activeArena != _arena) {
+		_arenaChannels.clear();
+	}
+	_activeArena = nullptr;
+	if (decrementRefCount) {
+		_arena = nullptr;
+	}
 
 	_processSetup = {};
 	_processContext = {};
+	_contextRequirements = ~0u;
+	if (decrementRefCount) {
+		_transport = nullptr;
+	}
 
-	_sampleRate = 0;
-	_maxBlockSize = 0;
-	_symbolicSampleSize = 0;
+	_inParameterChanges.clearQueue();
+	_outParameterChanges.clearQueue();
+	_pendingParameterChanges.clear();
+	_samplePosition.store(0, std::memory_order_relaxed);
+
+	_pendingEvents.clear();
+	_dueEvents.clear();
+	_eventSequence = 0;
+
+	_metrics.reset();
+	_audit.disable();
+
+	_silentInputSamples = 0;
+	_outputSilent = false;
+
+	_sampleRate = 0;
+	_maxBlockSize = 0;
+	_preparedBlockSize = 0;
+	++_bufferGeneration;
+	_symbolicSampleSize = 0;
 	_realtime = false;
+	_processing = false;
 
 	_path = "";
 	_name = "";
 
-	if (decrementRefCount) {
-		if (_standardPluginContextRefCount > 0) {
-			--_standardPluginContextRefCount;
+	if (decrementRefCount && _holdsPluginContext) {
+		_releasePluginContext();
+		_holdsPluginContext = false;
+	}
+}
+
+void EasyVst::_configure(const std::string &path, int sampleRate, int maxBlockSize, int symbolicSampleSize, bool realtime)
+{
+	_path = path;
+	_sampleRate = sampleRate;
+	_maxBlockSize = maxBlockSize;
+	_symbolicSampleSize = symbolicSampleSize;
+	_realtime = realtime;
+
+	_processSetup.processMode = _realtime ? kRealtime : kOffline;
+	_processSetup.symbolicSampleSize = _symbolicSampleSize;
+	_processSetup.sampleRate = _sampleRate;
+	_processSetup.maxSamplesPerBlock = _maxBlockSize;
+
+	_processData.numSamples = 0;
+	_processData.processMode = _processSetup.processMode;
+	_processData.symbolicSampleSize = _symbolicSampleSize;
+	_processData.processContext = &_processContext;
+	_processData.inputParameterChanges = &_inParameterChanges;
+	_processData.outputParameterChanges = &_outParameterChanges;
+}
+
+VST3::Hosting::Module::Ptr EasyVst::_loadModule(const std::string &path, std::string &error)
+{
+	{
+		std::lock_guard<std::mutex> lock(_moduleCacheMutex);
+
+		auto it = _moduleCache.find(path);
+		if (it != _moduleCache.end()) {
+			VST3::Hosting::Module::Ptr module = it->second.lock();
+			if (module) {
+				return module;
+			}
 		}
-		if (_standardPluginContext && _standardPluginContextRefCount == 0) {
-			PluginContextFactory::instance().setPluginContext(nullptr);
-			_standardPluginContext->release();
-			delete _standardPluginContext;
-			_standardPluginContext = nullptr;
+	}
+
+	// Load outside the lock so different modules can be loaded in parallel
+	VST3::Hosting::Module::Ptr module = VST3::Hosting::Module::create(path, error);
+
+	std::lock_guard<std::mutex> lock(_moduleCacheMutex);
+
+	auto it = _moduleCache.find(path);
+	VST3::Hosting::Module::Ptr cached = it != _moduleCache.end() ? it->second.lock() : nullptr;
+	if (cached) {
+		// Another thread loaded the same module meanwhile; share its instance
+		module = cached;
+	} else if (module) {
+		_moduleCache[path] = module;
+	} else {
+		_moduleCache.erase(path);
+	}
+
+	// Drop entries whose modules have been unloaded since they were cached
+	for (auto entry = _moduleCache.begin(); entry != _moduleCache.end();) {
+		if (entry->second.expired()) {
+			entry = _moduleCache.erase(entry);
+		} else {
+			++entry;
+		}
+	}
+
+	return module;
+}
+
+std::shared_ptr<const EasyVstParameterIndex> EasyVst::_loadParameterIndex(const std::string &key, IEditController *controller)
+{
+	{
+		std::lock_guard<std::mutex> lock(_parameterIndexCacheMutex);
+
+		auto it = _parameterIndexCache.find(key);
+		if (it != _parameterIndexCache.end()) {
+			std::shared_ptr<const EasyVstParameterIndex> index = it->second.lock();
+			if (index) {
+				return index;
+			}
+		}
+	}
+
+	// Build outside the lock so that loading one plugin does not stall the others
+	auto built = std::make_shared<EasyVstParameterIndex>();
+	if (!built->build(controller)) {
+		return nullptr;
+	}
+	std::shared_ptr<const EasyVstParameterIndex> index = built;
+
+	std::lock_guard<std::mutex> lock(_parameterIndexCacheMutex);
+
+	auto it = _parameterIndexCache.find(key);
+	std::shared_ptr<const EasyVstParameterIndex> cached = it != _parameterIndexCache.end() ? it->second.lock() : nullptr;
+	if (cached) {
+		// Another instance of the same plugin built it meanwhile; share that one
+		index = cached;
+	} else {
+		_parameterIndexCache[key] = index;
+	}
+
+	for (auto entry = _parameterIndexCache.begin(); entry != _parameterIndexCache.end();) {
+		if (entry->second.expired()) {
+			entry = _parameterIndexCache.erase(entry);
+		} else {
+			++entry;
 		}
 	}
+
+	return index;
+}
+
+bool EasyVst::_setProcessMode(int32 processMode)
+{
+	if (_processSetup.processMode == processMode) {
+		return true;
+	}
+
+	bool wasProcessing = _processing;
+	if (wasProcessing) {
+		setProcessing(false);
+	}
+	_vstPlug->setActive(false);
+
+	int32 previousMode = _processSetup.processMode;
+	_processSetup.processMode = processMode;
+	_processData.processMode = processMode;
+	bool success = _audioEffect->setupProcessing(_processSetup) == kResultOk;
+	if (!success) {
+		_printError("Failed to setup VST processing for new process mode");
+	} else if (_vstPlug->setActive(true) != kResultTrue) {
+		_printError("Failed to reactivate VST component");
+		_vstPlug->setActive(false);
+		success = false;
+	}
+
+	// Keep the previous mode and leave the plugin running as it was
+	if (!success) {
+		_processSetup.processMode = previousMode;
+		_processData.processMode = previousMode;
+		_audioEffect->setupProcessing(_processSetup);
+		_vstPlug->setActive(true);
+	}
+	if (wasProcessing) {
+		setProcessing(true);
+	}
+
+	return success;
+}
+
+void EasyVst::_advanceProcessContext(int numSamples)
+{
+	_processContext.projectTimeSamples += numSamples;
+	_processContext.continousTimeSamples += numSamples;
+	if (_processContext.state & ProcessContext::kTempoValid) {
+		_processContext.projectTimeMusic += numSamples * _processContext.tempo / (60.0 * _processSetup.sampleRate);
+	}
+}
+
+template <typename SampleType>
+bool EasyVst::_renderOffline(const SampleType *const *inputs, SampleType *const *outputs, int64 totalFrames, int64 maxTailFrames)
+{
+	if (!_audioEffect) {
+		_printError("renderOffline() called on an uninitialized instance");
+		return false;
+	}
+
+	int expectedSampleSize = std::is_same<SampleType, Sample64>::value ? kSample64 : kSample32;
+	if (_symbolicSampleSize != expectedSampleSize) {
+		_printError("renderOffline() sample type does not match the initialized sample size");
+		return false;
+	}
+
+	int numInChannels = inputs ? numChannels(kInput, 0) : 0;
+	int numOutChannels = outputs ? numChannels(kOutput, 0) : 0;
+	bool validChannels = totalFrames >= 0;
+	for (int i = 0; i < numInChannels && validChannels; ++i) {
+		validChannels = inputs[i] != nullptr;
+	}
+	for (int i = 0; i < numOutChannels && validChannels; ++i) {
+		validChannels = outputs[i] != nullptr;
+	}
+	if (!validChannels) {
+		_printError("renderOffline() needs one non-null channel per bus 0 channel and a non-negative length");
+		return false;
+	}
+
+	if (!_setProcessMode(kOffline)) {
+		return false;
+	}
+
+	bool wasProcessing = _processing;
+	if (!wasProcessing) {
+		setProcessing(true);
+	}
+
+	SampleType **inBuffers = numInChannels > 0 ? busChannels<SampleType>(_hostBuses(kInput)[0]) : nullptr;
+	SampleType **outBuffers = numOutChannels > 0 ? busChannels<SampleType>(_hostBuses(kOutput)[0]) : nullptr;
+
+	int64 pluginTail = tailSamples();
+	if (maxTailFrames < 0) {
+		maxTailFrames = pluginTail;
+	}
+	int64 tailFrames = std::min(pluginTail, maxTailFrames);
+	int64 renderFrames = totalFrames + tailFrames;
+
+	// The render runs on the instance's own context, starting from the shared transport's position, so
+	// other instances sharing the transport are not moved along with it
+	std::shared_ptr<EasyVstTransport> transport = std::move(_transport);
+	if (transport) {
+		transport->fill(_processContext, _contextRequirements);
+	}
+	_processContext.sampleRate = _processSetup.sampleRate;
+	_processContext.state |= ProcessContext::kContTimeValid;
+
+	bool success = true;
+	for (int64 position = 0; position < renderFrames; position += _maxBlockSize) {
+		int numSamples = static_cast<int>(std::min<int64>(_maxBlockSize, renderFrames - position));
+		int64 inputFrames = std::max<int64>(0, std::min<int64>(numSamples, totalFrames - position));
+
+		for (int i = 0; i < numInChannels; ++i) {
+			if (inputFrames > 0) {
+				std::memcpy(inBuffers[i], inputs[i] + position, inputFrames * sizeof(SampleType));
+			}
+			std::fill(inBuffers[i] + inputFrames, inBuffers[i] + numSamples, SampleType(0));
+		}
+
+		if (!process(numSamples)) {
+			success = false;
+			break;
+		}
+
+		for (int i = 0; i < numOutChannels; ++i) {
+			std::memcpy(outputs[i] + position, outBuffers[i], numSamples * sizeof(SampleType));
+		}
+
+		_advanceProcessContext(numSamples);
+	}
+
+	if (success) {
+		for (int i = 0; i < numOutChannels; ++i) {
+			std::fill(outputs[i] + renderFrames, outputs[i] + totalFrames + maxTailFrames, SampleType(0));
+		}
+	}
+
+	_transport = std::move(transport);
+	if (!wasProcessing) {
+		setProcessing(false);
+	}
+
+	if (!_setProcessMode(_realtime ? kRealtime : kOffline)) {
+		return false;
+	}
+
+	return success;
+}
+
+void EasyVst::_prepareParameterChanges()
+{
+	int maxParameters = MIN_QUEUED_PARAMETERS;
+	if (_editController) {
+		maxParameters = std::max(maxParameters, static_cast<int>(_editController->getParameterCount()));
+	}
+
+	_inParameterChanges.setMaxParameters(maxParameters);
+	_outParameterChanges.setMaxParameters(maxParameters);
+
+	// Grow every value queue once here so that adding points in process() does not allocate
+	for (ParameterChanges *changes : { &_inParameterChanges, &_outParameterChanges }) {
+		for (int i = 0; i < maxParameters; ++i) {
+			int32 queueIndex = 0;
+			IParamValueQueue *queue = changes->addParameterData(static_cast<ParamID>(i), queueIndex);
+			for (int j = 0; queue && j < RESERVED_POINTS_PER_PARAMETER; ++j) {
+				int32 pointIndex = 0;
+				queue->addPoint(j, 0.0, pointIndex);
+			}
+		}
+		changes->clearQueue();
+	}
+
+	_parameterQueue.reset(_parameterQueueCapacity);
+	_outputParameterQueue.reset(_parameterQueueCapacity);
+	_pendingParameterChanges.clear();
+	_pendingParameterChanges.reserve(_parameterQueueCapacity);
+}
+
+void EasyVst::_drainParameterQueue(int numSamples)
+{
+	EASYVST_TRACE_SCOPE("EasyVst::drainParameterQueue", _name, numSamples);
+
+	_inParameterChanges.clearQueue();
+
+	int64 blockEnd = _samplePosition.load(std::memory_order_relaxed) + numSamples;
+
+	size_t numKept = 0;
+	for (const ParameterChangePoint &change : _pendingParameterChanges) {
+		if (change.samplePosition < blockEnd) {
+			_addParameterPoint(change);
+		} else {
+			_pendingParameterChanges[numKept++] = change;
+		}
+	}
+	_pendingParameterChanges.resize(numKept);
+
+	ParameterChangePoint change;
+	while (_parameterQueue.pop(change)) {
+		if (change.samplePosition < blockEnd) {
+			_addParameterPoint(change);
+		} else if (_pendingParameterChanges.size() < _pendingParameterChanges.capacity()) {
+			_pendingParameterChanges.push_back(change);
+		} else {
+			_parameterQueueOverflows.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+}
+
+void EasyVst::_drainOutputParameterChanges()
+{
+	int64 blockStart = _samplePosition.load(std::memory_order_relaxed);
+
+	// Only the last point of each parameter is passed on; the controller just needs the latest value
+	int32 numParameters = _outParameterChanges.getParameterCount();
+	for (int32 i = 0; i < numParameters; ++i) {
+		IParamValueQueue *queue = _outParameterChanges.getParameterData(i);
+		int32 numPoints = queue ? queue->getPointCount() : 0;
+		if (numPoints == 0) {
+			continue;
+		}
+
+		ParameterChangePoint change;
+		int32 sampleOffset = 0;
+		change.id = queue->getParameterId();
+		queue->getPoint(numPoints - 1, sampleOffset, change.value);
+		change.samplePosition = blockStart + sampleOffset;
+		if (!_outputParameterQueue.push(change)) {
+			_outputParameterQueueOverflows.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+}
+
+void EasyVst::_addParameterPoint(const ParameterChangePoint &change)
+{
+	int64 offset = change.samplePosition - _samplePosition.load(std::memory_order_relaxed);
+
+	int32 queueIndex = 0;
+	IParamValueQueue *queue = _inParameterChanges.addParameterData(change.id, queueIndex);
+	if (!queue) {
+		_parameterQueueOverflows.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	int32 pointIndex = 0;
+	queue->addPoint(static_cast<int32>(std::max<int64>(offset, 0)), change.value, pointIndex);
+}
+
+bool EasyVst::_prepareEventScheduler()
+{
+	if (_numInEventBuses > 0) {
+		_inEventLists = _createEventLists(_numInEventBuses);
+		_processData.inputEvents = _inEventLists;
+	}
+	if (_numOutEventBuses > 0) {
+		_outEventLists = _createEventLists(_numOutEventBuses);
+		_processData.outputEvents = _outEventLists;
+	}
+	if ((_numInEventBuses > 0 && !_inEventLists) || (_numOutEventBuses > 0 && !_outEventLists)) {
+		_printError("Failed to place event lists in the arena");
+		return false;
+	}
+
+	for (int i = 0; i < _numInEventBuses; ++i) {
+		_inEventLists[i].setMaxSize(_eventCapacity);
+	}
+	for (int i = 0; i < _numOutEventBuses; ++i) {
+		_outEventLists[i].setMaxSize(_eventCapacity);
+	}
+
+	_eventQueue.reset(_eventCapacity);
+	_pendingEvents.clear();
+	_pendingEvents.reserve(_eventCapacity);
+	_dueEvents.clear();
+	_dueEvents.reserve(_eventCapacity);
+	return true;
+}
+
+Steinberg::Vst::EventList *EasyVst::_createEventLists(int count)
+{
+	void *memory = _activeArena ? _activeArena->allocate(sizeof(EventList) * count) : ::operator new(sizeof(EventList) * count);
+	if (!memory) {
+		return nullptr;
+	}
+	EventList *lists = static_cast<EventList *>(memory);
+	for (int i = 0; i < count; ++i) {
+		new (&lists[i]) EventList();
+	}
+	return lists;
+}
+
+void EasyVst::_destroyEventLists(EventList *&lists, int count)
+{
+	if (!lists) {
+		return;
+	}
+
+	for (int i = 0; i < count; ++i) {
+		lists[i].~EventList();
+	}
+	// Lists placed in an arena go away with the arena
+	if (!_activeArena) {
+		::operator delete(lists);
+	}
+	lists = nullptr;
+}
+
+void EasyVst::_drainEventQueue(int numSamples)
+{
+	EASYVST_TRACE_SCOPE("EasyVst::drainEventQueue", _name, numSamples);
+
+	if (!_inEventLists) {
+		return;
+	}
+
+	int64 blockStart = _samplePosition.load(std::memory_order_relaxed);
+	int64 blockEnd = blockStart + numSamples;
+
+	_dueEvents.clear();
+
+	size_t numKept = 0;
+	for (const ScheduledEvent &scheduled : _pendingEvents) {
+		if (scheduled.time < blockEnd) {
+			_dueEvents.push_back(scheduled);
+		} else {
+			_pendingEvents[numKept++] = scheduled;
+		}
+	}
+	_pendingEvents.resize(numKept);
+
+	// Host timestamps are played back one block late so that events received during the previous
+	// block keep their relative spacing instead of all landing on the first sample
+	int64 blockStartNs = 0;
+	ScheduledEvent scheduled;
+	while (_eventQueue.pop(scheduled)) {
+		if (scheduled.isHostTime) {
+			if (blockStartNs == 0) {
+				blockStartNs = hostTimeNs();
+			}
+			double offset = (scheduled.time - blockStartNs) * _processSetup.sampleRate / 1e9;
+			scheduled.time = blockStart + numSamples + static_cast<int64>(offset);
+			scheduled.isHostTime = false;
+		}
+		scheduled.sequence = _eventSequence++;
+
+		if (scheduled.time < blockEnd) {
+			if (_dueEvents.size() < _dueEvents.capacity()) {
+				_dueEvents.push_back(scheduled);
+			} else {
+				_eventOverflows.fetch_add(1, std::memory_order_relaxed);
+			}
+		} else if (_pendingEvents.size() < _pendingEvents.capacity()) {
+			_pendingEvents.push_back(scheduled);
+		} else {
+			_eventOverflows.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	if (_dueEvents.empty()) {
+		return;
+	}
+
+	std::sort(_dueEvents.begin(), _dueEvents.end(), [](const ScheduledEvent &a, const ScheduledEvent &b) {
+		return a.time != b.time ? a.time < b.time : a.sequence < b.sequence;
+	});
+
+	// Scheduled events cannot be added to a graph source's output list, so this block gets a copy of it
+	if (_sharedInputEvents) {
+		int numShared = _sharedInputEvents->getEventCount();
+		for (int i = 0; i < numShared; ++i) {
+			Event event = {};
+			if (_sharedInputEvents->getEvent(i, event) == kResultOk && _inEventLists[0].addEvent(event) != kResultOk) {
+				_eventOverflows.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		_processData.inputEvents = _inEventLists;
+	}
+
+	for (ScheduledEvent &due : _dueEvents) {
+		due.event.sampleOffset = static_cast<int32>(std::max<int64>(due.time - blockStart, 0));
+		if (due.event.busIndex < 0 || due.event.busIndex >= _numInEventBuses || _inEventLists[due.event.busIndex].addEvent(due.event) != kResultOk) {
+			_eventOverflows.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	// Events pulled in by a graph are already in the lists
+	for (int i = 0; i < _numInEventBuses; ++i) {
+		_sortEvents(_inEventLists[i]);
+	}
+}
+
+// IAudioProcessor takes a single input event list with a bus index on each event, so the lists of the
+// other buses are appended to the first one before it is handed over
+void EasyVst::_mergeInputEventBuses()
+{
+	if (_numInEventBuses < 2 || _processData.inputEvents != _inEventLists) {
+		return;
+	}
+
+	bool merged = false;
+	for (int i = 1; i < _numInEventBuses; ++i) {
+		int numEvents = _inEventLists[i].getEventCount();
+		for (int j = 0; j < numEvents; ++j) {
+			if (_inEventLists[0].addEvent(*_inEventLists[i].getEventByIndex(j)) != kResultOk) {
+				_eventOverflows.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		merged = merged || numEvents > 0;
+	}
+
+	if (merged) {
+		_sortEvents(_inEventLists[0]);
+	}
+}
+
+// Stable insertion sort by sample offset; event lists are short and mostly in order already, and this
+// runs on the audio thread so it must not allocate
+void EasyVst::_sortEvents(EventList &events)
+{
+	int numEvents = events.getEventCount();
+	for (int i = 1; i < numEvents; ++i) {
+		Event event = *events.getEventByIndex(i);
+		int j = i;
+		while (j > 0 && events.getEventByIndex(j - 1)->sampleOffset > event.sampleOffset) {
+			*events.getEventByIndex(j) = *events.getEventByIndex(j - 1);
+			--j;
+		}
+		*events.getEventByIndex(j) = event;
+	}
+}
+
+bool EasyVst::_updateInputSilence(int numSamples)
+{
+	AudioBusBuffers *buses = _hostBuses(kInput);
+	bool detect = _silencePolicy.load(std::memory_order_relaxed) == EasyVstSilencePolicy::kSkipWhenSilent;
+
+	bool allSilent = true;
+	for (int i = 0; i < _processData.numInputs; ++i) {
+		AudioBusBuffers &bus = buses[i];
+		bus.silenceFlags = detect ? silentChannels(bus, _symbolicSampleSize, numSamples) : 0;
+		allSilent = allSilent && bus.silenceFlags == allChannelsMask(bus.numChannels);
+	}
+
+	return detect && allSilent;
+}
+
+bool EasyVst::_updateOutputSilence(int numSamples)
+{
+	AudioBusBuffers *buses = _hostBuses(kOutput);
+
+	for (int i = 0; i < _processData.numOutputs; ++i) {
+		AudioBusBuffers &bus = buses[i];
+		uint64 mask = allChannelsMask(bus.numChannels);
+		if ((bus.silenceFlags & mask) != mask && (silentChannels(bus, _symbolicSampleSize, numSamples) & mask) != mask) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool EasyVst::_canSkipBlock(bool inputSilent, int numSamples)
+{
+	bool hasEvents = _inParameterChanges.getParameterCount() > 0;
+	if (_processData.inputEvents != _inEventLists) {
+		hasEvents = hasEvents || _processData.inputEvents->getEventCount() > 0;
+	}
+	for (int i = 0; i < _numInEventBuses && _inEventLists && !hasEvents; ++i) {
+		hasEvents = _inEventLists[i].getEventCount() > 0;
+	}
+
+	if (!inputSilent || hasEvents) {
+		_silentInputSamples = 0;
+		return false;
+	}
+
+	// The tail is only queried when the input falls silent, and counts from there
+	if (_silentInputSamples == 0) {
+		uint32 tail = _audioEffect ? _audioEffect->getTailSamples() : kInfiniteTail;
+		_silenceTailSamples = tail == kInfiniteTail ? -1 : static_cast<int64>(tail) + latencySamples();
+	}
+
+	bool skip = _outputSilent && _silenceTailSamples >= 0 && _silentInputSamples >= _silenceTailSamples;
+	_silentInputSamples += numSamples;
+	return skip;
+}
+
+void EasyVst::_skipBlock(int numSamples)
+{
+	AudioBusBuffers *buses = _hostBuses(kOutput);
+	for (int i = 0; i < _processData.numOutputs; ++i) {
+		AudioBusBuffers &bus = buses[i];
+		for (int j = 0; j < bus.numChannels; ++j) {
+			if (_symbolicSampleSize == kSample64) {
+				std::fill(bus.channelBuffers64[j], bus.channelBuffers64[j] + numSamples, 0.0);
+			} else {
+				std::fill(bus.channelBuffers32[j], bus.channelBuffers32[j] + numSamples, 0.0f);
+			}
+		}
+		bus.silenceFlags = allChannelsMask(bus.numChannels);
+	}
+
+	_skippedBlocks.fetch_add(1, std::memory_order_relaxed);
+	_samplePosition.fetch_add(numSamples, std::memory_order_relaxed);
+}
+
+bool EasyVst::_prepareBuffers(int32 pluginSampleSize)
+{
+	// With an arena, HostProcessData only allocates the bus arrays and the channels are placed in the arena
+	int32 bufferSamples = _activeArena ? 0 : _maxBlockSize;
+
+	_processData.prepare(*_vstPlug, bufferSamples, pluginSampleSize);
+	if (_convertSampleSize) {
+		_hostBuffers.prepare(*_vstPlug, bufferSamples, _symbolicSampleSize);
+	}
+
+	if (_activeArena) {
+		for (ArenaChannel &channel : _arenaChannels) {
+			channel.used = false;
+		}
+		bool placed = _placeChannelBuffers(_processData, pluginSampleSize);
+		if (placed && _convertSampleSize) {
+			placed = _placeChannelBuffers(_hostBuffers, _symbolicSampleSize);
+		}
+		if (!placed) {
+			_printError("Failed to place process buffers in the arena");
+			return false;
+		}
+	}
+
+	_preparedBlockSize = _maxBlockSize;
+	return true;
+}
+
+bool EasyVst::_placeChannelBuffers(ProcessData &data, int32 sampleSize)
+{
+	size_t channelBytes = static_cast<size_t>(_maxBlockSize) * (sampleSize == kSample64 ? sizeof(Sample64) : sizeof(Sample32));
+	for (int direction = kInput; direction <= kOutput; ++direction) {
+		AudioBusBuffers *buses = direction == kInput ? data.inputs : data.outputs;
+		int numBusBuffers = direction == kInput ? data.numInputs : data.numOutputs;
+		for (int i = 0; i < numBusBuffers; ++i) {
+			for (int j = 0; j < buses[i].numChannels; ++j) {
+				void *channel = _allocateArenaChannel(channelBytes);
+				if (!channel) {
+					return false;
+				}
+				std::memset(channel, 0, channelBytes);
+				if (sampleSize == kSample64) {
+					buses[i].channelBuffers64[j] = static_cast<Sample64 *>(channel);
+				} else {
+					buses[i].channelBuffers32[j] = static_cast<Sample32 *>(channel);
+				}
+			}
+		}
+	}
+	return true;
+}
+
+void *EasyVst::_allocateArenaChannel(size_t bytes)
+{
+	// Channels left over from an earlier configuration are reused before the arena is asked for more
+	for (ArenaChannel &channel : _arenaChannels) {
+		if (!channel.used && channel.bytes >= bytes) {
+			channel.used = true;
+			return channel.memory;
+		}
+	}
+
+	void *memory = _activeArena->allocate(bytes);
+	if (memory) {
+		ArenaChannel channel;
+		channel.memory = memory;
+		channel.bytes = bytes;
+		channel.used = true;
+		_arenaChannels.push_back(channel);
+	}
+	return memory;
+}
+
+Steinberg::Vst::AudioBusBuffers *EasyVst::_hostBuses(BusDirection direction)
+{
+	ProcessData &data = _convertSampleSize ? static_cast<ProcessData &>(_hostBuffers) : static_cast<ProcessData &>(_processData);
+	return direction == kInput ? data.inputs : data.outputs;
+}
+
+void EasyVst::_convertBuses(BusDirection direction, int numSamples)
+{
+	AudioBusBuffers *hostBuses = _hostBuses(direction);
+	AudioBusBuffers *pluginBuses = direction == kInput ? _processData.inputs : _processData.outputs;
+	int numBusBuffers = direction == kInput ? _processData.numInputs : _processData.numOutputs;
+
+	for (int i = 0; i < numBusBuffers; ++i) {
+		AudioBusBuffers &hostBus = hostBuses[i];
+		AudioBusBuffers &pluginBus = pluginBuses[i];
+		for (int j = 0; j < hostBus.numChannels; ++j) {
+			if (direction == kInput && _symbolicSampleSize == kSample32) {
+				EasyVstSampleConvert::convert(hostBus.channelBuffers32[j], pluginBus.channelBuffers64[j], numSamples, 1.0);
+			} else if (direction == kInput) {
+				EasyVstSampleConvert::convert(hostBus.channelBuffers64[j], pluginBus.channelBuffers32[j], numSamples, 1.0);
+			} else if (_symbolicSampleSize == kSample32) {
+				EasyVstSampleConvert::convert(pluginBus.channelBuffers64[j], hostBus.channelBuffers32[j], numSamples, 1.0);
+			} else {
+				EasyVstSampleConvert::convert(pluginBus.channelBuffers32[j], hostBus.channelBuffers64[j], numSamples, 1.0);
+			}
+		}
+
+		if (direction == kInput) {
+			pluginBus.silenceFlags = hostBus.silenceFlags;
+		} else {
+			hostBus.silenceFlags = pluginBus.silenceFlags;
+		}
+	}
+}
+
+void EasyVst::_snapshotChannelBuffers()
+{
+	_oneShotBindings.clear();
+	_oneShotBindings.reserve(_processData.numInputs + _processData.numOutputs);
+
+	_graphInputs.assign(_processData.numInputs, false);
+	for (int direction = kInput; direction <= kOutput; ++direction) {
+		int numBusBuffers = direction == kInput ? _processData.numInputs : _processData.numOutputs;
+		_ownedChannelBuffers[direction].resize(numBusBuffers);
+		_bindingCapacity[direction].assign(numBusBuffers, 0);
+		for (int i = 0; i < numBusBuffers; ++i) {
+			AudioBusBuffers &bus = _hostBuses(direction)[i];
+			_ownedChannelBuffers[direction][i].resize(bus.numChannels);
+			for (int j = 0; j < bus.numChannels; ++j) {
+				_ownedChannelBuffers[direction][i][j] = _channelBuffer(direction, i, j);
+			}
+		}
+	}
+}
+
+void EasyVst::_restoreChannelBuffers()
+{
+	for (int direction = kInput; direction <= kOutput; ++direction) {
+		for (int i = 0; i < static_cast<int>(_ownedChannelBuffers[direction].size()); ++i) {
+			_unbindAudioBus(direction, i);
+		}
+	}
+}
+
+void *EasyVst::_channelBuffer(BusDirection direction, int which, int channel)
+{
+	AudioBusBuffers &bus = _hostBuses(direction)[which];
+	if (_symbolicSampleSize == kSample64) {
+		return bus.channelBuffers64[channel];
+	} else {
+		return bus.channelBuffers32[channel];
+	}
+}
+
+void EasyVst::_bindAudioBus(BusDirection direction, int which, void *const *channelBuffers)
+{
+	AudioBusBuffers &bus = _hostBuses(direction)[which];
+	for (int i = 0; i < bus.numChannels; ++i) {
+		if (_symbolicSampleSize == kSample64) {
+			bus.channelBuffers64[i] = static_cast<Sample64 *>(channelBuffers[i]);
+		} else {
+			bus.channelBuffers32[i] = static_cast<Sample32 *>(channelBuffers[i]);
+		}
+	}
+}
+
+template <typename SampleType>
+bool EasyVst::_bindBuffers(BusDirection direction, int which, SampleType *const *channelBuffers, int numChannels, int capacityFrames, bool persistent)
+{
+	if (_sandbox) {
+		_printError("External buffers cannot be bound to a sandboxed VST");
+		return false;
+	}
+	if ((direction != kInput && direction != kOutput) || which < 0 || which >= static_cast<int>(_ownedChannelBuffers[direction].size())) {
+		_printError("Invalid bus for external buffers");
+		return false;
+	}
+	if (direction == kInput && _graphInputs[which]) {
+		_printError("Bus is fed by an EasyVstGraph and cannot be bound to external buffers");
+		return false;
+	}
+
+	int expectedSampleSize = std::is_same<SampleType, Sample64>::value ? kSample64 : kSample32;
+	if (_symbolicSampleSize != expectedSampleSize) {
+		_printError("External buffer sample type does not match the initialized sample size");
+		return false;
+	}
+
+	AudioBusBuffers &bus = _hostBuses(direction)[which];
+	if (!channelBuffers || numChannels != bus.numChannels) {
+		_printError("External buffers must provide one channel per bus channel");
+		return false;
+	}
+	if (capacityFrames < _maxBlockSize) {
+		_printError("External buffers are smaller than the maximum block size");
+		return false;
+	}
+	for (int i = 0; i < numChannels; ++i) {
+		if (!channelBuffers[i] || reinterpret_cast<uintptr_t>(channelBuffers[i]) % EXTERNAL_BUFFER_ALIGNMENT != 0) {
+			_printError("External channel buffer is null or not 16-byte aligned");
+			return false;
+		}
+	}
+
+	static_assert(sizeof(SampleType *) == sizeof(void *), "Channel pointers must be interchangeable with void pointers");
+	_bindAudioBus(direction, which, reinterpret_cast<void *const *>(channelBuffers));
+	_bindingCapacity[direction][which] = capacityFrames;
+	if (!persistent) {
+		_oneShotBindings.emplace_back(direction, which);
+	}
+
+	return true;
+}
+
+void EasyVst::_releaseOneShotBindings()
+{
+	for (const auto &binding : _oneShotBindings) {
+		_unbindAudioBus(binding.first, binding.second);
+	}
+	_oneShotBindings.clear();
+}
+
+void EasyVst::_unbindAudioBus(BusDirection direction, int which)
+{
+	if (which < 0 || which >= static_cast<int>(_ownedChannelBuffers[direction].size())) {
+		return;
+	}
+	const std::vector<void *> &owned = _ownedChannelBuffers[direction][which];
+	if (static_cast<int>(owned.size()) == _hostBuses(direction)[which].numChannels) {
+		_bindAudioBus(direction, which, owned.data());
+	}
+	_bindingCapacity[direction][which] = 0;
+}
+
+void EasyVst::_shareInputBus(int which, void *const *channelBuffers)
+{
+	_bindAudioBus(kInput, which, channelBuffers);
+	_bindingCapacity[kInput][which] = 0;
+	_graphInputs[which] = true;
+}
+
+void EasyVst::_unshareInputBus(int which)
+{
+	if (which < 0 || which >= static_cast<int>(_graphInputs.size()) || !_graphInputs[which]) {
+		return;
+	}
+	_graphInputs[which] = false;
+	_unbindAudioBus(kInput, which);
+}
+
+void EasyVst::_bindInputEvents(IEventList *events)
+{
+	_sharedInputEvents = events;
+	_processData.inputEvents = events ? events : _inEventLists;
+}
+
+void EasyVst::_acquirePluginContext()
+{
+	// While another reference keeps the context alive, taking one more needs no lock
+	int count = _standardPluginContextRefCount.load(std::memory_order_relaxed);
+	while (count > 0) {
+		if (_standardPluginContextRefCount.compare_exchange_weak(count, count + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+			return;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(_pluginContextMutex);
+
+	// Publish the count only once the context exists, so the fast path never sees a missing context
+	if (!_standardPluginContext) {
+		_standardPluginContext = NEW HostApplication();
+		PluginContextFactory::instance().setPluginContext(_standardPluginContext);
+	}
+	_standardPluginContextRefCount.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void EasyVst::_releasePluginContext()
+{
+	// Only the reference that may drop the count to zero has to take the lock
+	int count = _standardPluginContextRefCount.load(std::memory_order_relaxed);
+	while (count > 1) {
+		if (_standardPluginContextRefCount.compare_exchange_weak(count, count - 1, std::memory_order_release, std::memory_order_relaxed)) {
+			return;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(_pluginContextMutex);
+
+	count = _standardPluginContextRefCount.load(std::memory_order_acquire);
+	while (count > 0 && !_standardPluginContextRefCount.compare_exchange_weak(count, count - 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+	}
+	if (_standardPluginContext && count == 1) {
+		PluginContextFactory::instance().setPluginContext(nullptr);
+		_standardPluginContext->release();
+		_standardPluginContext = nullptr;
+	}
 }
 
 void EasyVst::_printDebug(const std::string &info)
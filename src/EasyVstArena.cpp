@@ -0,0 +1,169 @@
+#include <EasyVstArena.h>
+
+#include <algorithm>
+#include <iostream>
+#include <new>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define EASYVST_ARENA_MMAP
+#endif
+
+static const size_t HUGE_PAGE_SIZE = 2 << 20;
+
+static size_t alignUp(size_t value, size_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+EasyVstArena::EasyVstArena()
+{}
+
+EasyVstArena::~EasyVstArena()
+{
+	release();
+}
+
+bool EasyVstArena::reserve(size_t chunkSize, bool hugePages, bool lockMemory)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_chunkSize = alignUp(std::max<size_t>(chunkSize, CACHE_LINE_SIZE), hugePages ? HUGE_PAGE_SIZE : CACHE_LINE_SIZE);
+	_hugePages = hugePages;
+	_lockMemory = lockMemory;
+
+	return _mapChunk(_chunkSize);
+}
+
+void *EasyVstArena::allocate(size_t size, size_t alignment)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	alignment = std::max(alignment, CACHE_LINE_SIZE);
+	if (!_chunks.empty()) {
+		Chunk &chunk = _chunks.back();
+		size_t offset = alignUp(chunk.used, alignment);
+		if (offset + size <= chunk.size) {
+			chunk.used = offset + size;
+			return chunk.memory + offset;
+		}
+	}
+
+	if (!_mapChunk(std::max(_chunkSize, alignUp(size, alignment) + alignment))) {
+		return nullptr;
+	}
+
+	Chunk &chunk = _chunks.back();
+	size_t offset = alignUp(chunk.used, alignment);
+	chunk.used = offset + size;
+	return chunk.memory + offset;
+}
+
+void EasyVstArena::release()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	for (const Chunk &chunk : _chunks) {
+		_unmapChunk(chunk);
+	}
+	_chunks.clear();
+}
+
+size_t EasyVstArena::bytesUsed() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	size_t used = 0;
+	for (const Chunk &chunk : _chunks) {
+		used += chunk.used;
+	}
+	return used;
+}
+
+size_t EasyVstArena::bytesMapped() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	size_t mapped = 0;
+	for (const Chunk &chunk : _chunks) {
+		mapped += chunk.size;
+	}
+	return mapped;
+}
+
+bool EasyVstArena::usesHugePages() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return !_chunks.empty() && _chunks.back().hugePages;
+}
+
+bool EasyVstArena::isLocked() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return !_chunks.empty() && _chunks.back().locked;
+}
+
+bool EasyVstArena::_mapChunk(size_t minSize)
+{
+	Chunk chunk;
+	chunk.size = alignUp(minSize, _hugePages ? HUGE_PAGE_SIZE : CACHE_LINE_SIZE);
+
+#ifdef EASYVST_ARENA_MMAP
+	void *memory = MAP_FAILED;
+#ifdef MAP_HUGETLB
+	if (_hugePages) {
+		memory = mmap(nullptr, chunk.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		chunk.hugePages = memory != MAP_FAILED;
+	}
+#endif
+	if (memory == MAP_FAILED) {
+		memory = mmap(nullptr, chunk.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (memory == MAP_FAILED) {
+			_printError("Failed to map arena memory");
+			return false;
+		}
+#ifdef MADV_HUGEPAGE
+		// Without reserved hugepages, transparent hugepages are the next best thing
+		if (_hugePages && madvise(memory, chunk.size, MADV_HUGEPAGE) == 0) {
+			chunk.hugePages = true;
+		}
+#endif
+	}
+	chunk.memory = static_cast<char *>(memory);
+
+	if (_lockMemory) {
+		chunk.locked = mlock(chunk.memory, chunk.size) == 0;
+		if (!chunk.locked) {
+			_printError("Failed to lock arena memory, continuing unlocked");
+		}
+	}
+#else
+	// Mapped memory is page-aligned, so do the same here and let the first allocation start on a boundary
+	chunk.memory = static_cast<char *>(::operator new(chunk.size, std::align_val_t(4096), std::nothrow));
+	if (!chunk.memory) {
+		_printError("Failed to allocate arena memory");
+		return false;
+	}
+#endif
+
+	_chunks.push_back(chunk);
+	return true;
+}
+
+void EasyVstArena::_unmapChunk(const Chunk &chunk)
+{
+#ifdef EASYVST_ARENA_MMAP
+	if (chunk.locked) {
+		munlock(chunk.memory, chunk.size);
+	}
+	munmap(chunk.memory, chunk.size);
+#else
+	::operator delete(chunk.memory, std::align_val_t(4096));
+#endif
+}
+
+void EasyVstArena::_printError(const std::string &error)
+{
+	std::cerr << "EasyVstArena error: " << error << std::endl;
+}
@@ -0,0 +1,476 @@
+#ifdef EASYVST_AUDIT
+// The interposed I/O functions below would collide with the fortified inline wrappers
+#undef _FORTIFY_SOURCE
+#endif
+
+#include <EasyVstAudit.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#ifdef __linux__
+#include <execinfo.h>
+#endif
+
+#if defined(EASYVST_AUDIT) && defined(__linux__)
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace Steinberg;
+
+static thread_local EasyVstAudit *activeAudit __attribute__((tls_model("initial-exec"))) = nullptr;
+static thread_local bool reporting __attribute__((tls_model("initial-exec"))) = false;
+
+EasyVstAudit::EasyVstAudit()
+{}
+
+EasyVstAudit::~EasyVstAudit()
+{
+	disable();
+}
+
+bool EasyVstAudit::isAvailable()
+{
+#if defined(EASYVST_AUDIT) && defined(__linux__)
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool EasyVstAudit::enable(int capacity)
+{
+	if (!isAvailable()) {
+		return false;
+	}
+
+	_records.reset(capacity);
+	_overflows.store(0, std::memory_order_relaxed);
+
+#ifdef __linux__
+	// The first backtrace() loads the unwinder, which allocates; get that out of the way here
+	void *frame = nullptr;
+	backtrace(&frame, 1);
+#endif
+
+	_enabled.store(true, std::memory_order_release);
+	return true;
+}
+
+void EasyVstAudit::disable()
+{
+	_enabled.store(false, std::memory_order_release);
+}
+
+bool EasyVstAudit::isEnabled() const
+{
+	return _enabled.load(std::memory_order_acquire);
+}
+
+void EasyVstAudit::begin(int64 samplePosition)
+{
+	if (_enabled.load(std::memory_order_acquire)) {
+		_samplePosition = samplePosition;
+		activeAudit = this;
+	}
+}
+
+void EasyVstAudit::end()
+{
+	activeAudit = nullptr;
+}
+
+int EasyVstAudit::collect(std::vector<EasyVstAuditRecord> &records)
+{
+	int count = 0;
+	EasyVstAuditRecord record;
+	while (_records.pop(record)) {
+		records.push_back(record);
+		++count;
+	}
+	return count;
+}
+
+Steinberg::uint64 EasyVstAudit::overflows() const
+{
+	return _overflows.load(std::memory_order_relaxed);
+}
+
+const char *EasyVstAudit::kindName(EasyVstAuditKind kind)
+{
+	switch (kind) {
+	case EasyVstAuditKind::kAllocation:
+		return "allocation";
+	case EasyVstAuditKind::kDeallocation:
+		return "deallocation";
+	case EasyVstAuditKind::kMutexWait:
+		return "mutex wait";
+	case EasyVstAuditKind::kFileIo:
+		return "file I/O";
+	case EasyVstAuditKind::kSocketIo:
+		return "socket I/O";
+	}
+	return "unknown";
+}
+
+#ifdef __linux__
+std::vector<std::string> EasyVstAudit::symbolize(const EasyVstAuditRecord &record)
+{
+	std::vector<std::string> lines;
+
+	char **symbols = backtrace_symbols(record.frames, record.numFrames);
+	if (symbols) {
+		for (int i = 0; i < record.numFrames; ++i) {
+			lines.push_back(symbols[i]);
+		}
+		free(symbols);
+	}
+
+	return lines;
+}
+#else
+std::vector<std::string> EasyVstAudit::symbolize(const EasyVstAuditRecord & /*record*/)
+{
+	// Stacks are only captured on Linux
+	return {};
+}
+#endif
+
+void EasyVstAudit::report(EasyVstAuditKind kind, const char *function, size_t size)
+{
+	EasyVstAudit *audit = activeAudit;
+	if (!audit || reporting) {
+		return;
+	}
+
+	reporting = true;
+	int savedErrno = errno;
+
+	EasyVstAuditRecord record;
+	record.kind = kind;
+	record.function = function;
+	record.size = size;
+	record.samplePosition = audit->_samplePosition;
+#ifdef __linux__
+	// Skip report() and the interposed function itself
+	void *frames[EasyVstAuditRecord::MAX_FRAMES + 2];
+	int numFrames = backtrace(frames, EasyVstAuditRecord::MAX_FRAMES + 2);
+	for (int i = 2; i < numFrames; ++i) {
+		record.frames[record.numFrames++] = frames[i];
+	}
+#endif
+
+	if (!audit->_records.push(record)) {
+		audit->_overflows.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	errno = savedErrno;
+	reporting = false;
+}
+
+#if defined(EASYVST_AUDIT) && defined(__linux__)
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void __libc_free(void *pointer);
+}
+
+// dlsym() itself may allocate, which is fine since the allocator does not go through it
+template <typename Function>
+static Function realFunction(std::atomic<Function> &slot, const char *name)
+{
+	Function function = slot.load(std::memory_order_relaxed);
+	if (!function) {
+		function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+		slot.store(function, std::memory_order_relaxed);
+	}
+	return function;
+}
+
+static std::atomic<int (*)(void **, size_t, size_t)> realPosixMemalign{nullptr};
+static std::atomic<void *(*)(size_t, size_t)> realAlignedAlloc{nullptr};
+static std::atomic<int (*)(pthread_mutex_t *)> realMutexLock{nullptr}, realMutexTrylock{nullptr};
+static std::atomic<int (*)(const char *, int, ...)> realOpen{nullptr}, realOpen64{nullptr};
+static std::atomic<int (*)(int, const char *, int, ...)> realOpenat{nullptr};
+static std::atomic<int (*)(int)> realClose{nullptr};
+static std::atomic<ssize_t (*)(int, void *, size_t)> realRead{nullptr};
+static std::atomic<ssize_t (*)(int, const void *, size_t)> realWrite{nullptr};
+static std::atomic<FILE *(*)(const char *, const char *)> realFopen{nullptr};
+static std::atomic<int (*)(int, int, int)> realSocket{nullptr};
+static std::atomic<int (*)(int, const sockaddr *, socklen_t)> realConnect{nullptr};
+static std::atomic<int (*)(int, sockaddr *, socklen_t *)> realAccept{nullptr};
+static std::atomic<ssize_t (*)(int, const void *, size_t, int)> realSend{nullptr};
+static std::atomic<ssize_t (*)(int, void *, size_t, int)> realRecv{nullptr};
+static std::atomic<ssize_t (*)(int, const void *, size_t, int, const sockaddr *, socklen_t)> realSendto{nullptr};
+static std::atomic<ssize_t (*)(int, void *, size_t, int, sockaddr *, socklen_t *)> realRecvfrom{nullptr};
+
+// Resolve everything up front so that the first audited call does not have to
+__attribute__((constructor)) static void resolveRealFunctions()
+{
+	realFunction(realPosixMemalign, "posix_memalign");
+	realFunction(realAlignedAlloc, "aligned_alloc");
+	realFunction(realMutexLock, "pthread_mutex_lock");
+	realFunction(realMutexTrylock, "pthread_mutex_trylock");
+	realFunction(realOpen, "open");
+	realFunction(realOpen64, "open64");
+	realFunction(realOpenat, "openat");
+	realFunction(realClose, "close");
+	realFunction(realRead, "read");
+	realFunction(realWrite, "write");
+	realFunction(realFopen, "fopen");
+	realFunction(realSocket, "socket");
+	realFunction(realConnect, "connect");
+	realFunction(realAccept, "accept");
+	realFunction(realSend, "send");
+	realFunction(realRecv, "recv");
+	realFunction(realSendto, "sendto");
+	realFunction(realRecvfrom, "recvfrom");
+}
+
+static bool needsMode(int flags)
+{
+#ifdef O_TMPFILE
+	return (flags & O_CREAT) || (flags & O_TMPFILE) == O_TMPFILE;
+#else
+	return flags & O_CREAT;
+#endif
+}
+
+static void *allocate(size_t size, const char *function)
+{
+	EasyVstAudit::report(EasyVstAuditKind::kAllocation, function, size);
+	return __libc_malloc(size);
+}
+
+static void deallocate(void *pointer, const char *function)
+{
+	if (pointer) {
+		EasyVstAudit::report(EasyVstAuditKind::kDeallocation, function, 0);
+	}
+	__libc_free(pointer);
+}
+
+static void *allocateOrThrow(size_t size, const char *function)
+{
+	void *pointer = allocate(size ? size : 1, function);
+	if (!pointer) {
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+
+extern "C" {
+
+void *malloc(size_t size)
+{
+	return allocate(size, "malloc");
+}
+
+void *calloc(size_t count, size_t size)
+{
+	EasyVstAudit::report(EasyVstAuditKind::kAllocation, "calloc", count * size);
+	return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+	EasyVstAudit::report(EasyVstAuditKind::kAllocation, "realloc", size);
+	return __libc_realloc(pointer, size);
+}
+
+void free(void *pointer)
+{
+	deallocate(pointer, "free");
+}
+
+int posix_memalign(void **pointer, size_t alignment, size_t size)
+{
+	EasyVstAudit::report(EasyVstAuditKind::kAllocation, "posix_memalign", size);
+	return realFunction(realPosixMemalign, "posix_memalign")(pointer, alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+	EasyVstAudit::report(EasyVstAuditKind::kAllocation, "aligned_alloc", size);
+	return realFunction(realAlignedAlloc, "aligned_alloc")(alignment, size);
+}
+
+int pthread_mutex_lock(pthread_mutex_t *mutex)
+{
+	// Only contended locks are reported; an uncontended lock never leaves user space
+	if (activeAudit && !reporting) {
+		int result = realFunction(realMutexTrylock, "pthread_mutex_trylock")(mutex);
+		if (result != EBUSY) {
+			return result;
+		}
+		EasyVstAudit::report(EasyVstAuditKind::kMutexWait, "pthread_mutex_lock", 0);
+	}
+	return realFunction(realMutexLock, "pthread_mutex_lock")(mutex);
+}
+
+int open(const char *path, int flags, ...)
+{
+	mode_t mode = 0;
+	if (needsMode(flags)) {
+		va_list args;
+		va_start(args, flags);
+		mode = va_arg(args, mode_t);
+		va_end(args);
+	}
+	EasyVstAudit::report(EasyVstAuditKind::kFileIo, "open", 0);
+	return realFunction(realOpen, "open")(path, flags, mode);
+}
+
+int open64(const char *path, int flags, ...)
+{
+	mode_t mode = 0;
+	if (needsMode(flags)) {
+		va_list args;
+		va_start(args, flags);
+		mode = va_arg(args, mode_t);
+		va_end(args);
+	}
+	EasyVstAudit::report(EasyVstAuditKind::kFileIo, "open64", 0);
+	return realFunction(realOpen64, "open64")(path, flags, mode);
+}
+
+int openat(int dirFd, const char *path, int flags, ...)
+{
+	mode_t mode = 0;
+	if (needsMode(flags)) {
+		va_list args;
+		va_start(args, flags);
+		mode = va_arg(args, mode_t);
+		va_end(args);
+	}
+	EasyVstAudit::report(EasyVstAuditKind::kFileIo, "openat", 0);
+	return realFunction(realOpenat, "openat")(dirFd, path, flags, mode);
+}
+
+int close(int fd)
+{
+	EasyVstAudit::report(EasyVstAuditKind::kFileIo, "close", 0);
+	return realFunction(realClose, "close")(fd);
+}
+
+ssize_t read(int fd, void *buffer, size_t count)
+{
+	EasyVstAudit::report(EasyVstAuditKind::kFileIo, "read", count);
+	return realFunction(realRead, "read")(fd, buffer, count);
+}
+
+ssize_t write(int fd, const void *buffer, size_t count)
+{
+	EasyVstAudit::report(EasyVstAuditKind::kFileIo, "write", count);
+	return realFunction(realWrite, "write")(fd, buffer, count);
+}
+
+FILE *fopen(const char *path, const char *mode)
+{
+	EasyVstAudit::report(EasyVstAuditKind::kFileIo, "fopen", 0);
+	return realFunction(realFopen, "fopen")(path, mode);
+}
+
+int socket(int domain, int type, int protocol)
+{
+	EasyVstAudit::report(EasyVstAuditKind::kSocketIo, "socket", 0);
+	return realFunction(realSocket, "socket")(domain, type, protocol);
+}
+
+int connect(int fd, const sockaddr *address, socklen_t addressLength)
+{
+	EasyVstAudit::report(EasyVstAuditKind::kSocketIo, "connect", 0);
+	return realFunction(realConnect, "connect")(fd, address, addressLength);
+}
+
+int accept(int fd, sockaddr *address, socklen_t *addressLength)
+{
+	EasyVstAudit::report(EasyVstAuditKind::kSocketIo, "accept", 0);
+	return realFunction(realAccept, "accept")(fd, address, addressLength);
+}
+
+ssize_t send(int fd, const void *buffer, size_t count, int flags)
+{
+	EasyVstAudit::report(EasyVstAuditKind::kSocketIo, "send", count);
+	return realFunction(realSend, "send")(fd, buffer, count, flags);
+}
+
+ssize_t recv(int fd, void *buffer, size_t count, int flags)
+{
+	EasyVstAudit::report(EasyVstAuditKind::kSocketIo, "recv", count);
+	return realFunction(realRecv, "recv")(fd, buffer, count, flags);
+}
+
+ssize_t sendto(int fd, const void *buffer, size_t count, int flags, const sockaddr *address, socklen_t addressLength)
+{
+	EasyVstAudit::report(EasyVstAuditKind::kSocketIo, "sendto", count);
+	return realFunction(realSendto, "sendto")(fd, buffer, count, flags, address, addressLength);
+}
+
+ssize_t recvfrom(int fd, void *buffer, size_t count, int flags, sockaddr *address, socklen_t *addressLength)
+{
+	EasyVstAudit::report(EasyVstAuditKind::kSocketIo, "recvfrom", count);
+	return realFunction(realRecvfrom, "recvfrom")(fd, buffer, count, flags, address, addressLength);
+}
+}
+
+void *operator new(size_t size)
+{
+	return allocateOrThrow(size, "operator new");
+}
+
+void *operator new[](size_t size)
+{
+	return allocateOrThrow(size, "operator new[]");
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+	return allocate(size ? size : 1, "operator new");
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+	return allocate(size ? size : 1, "operator new[]");
+}
+
+void operator delete(void *pointer) noexcept
+{
+	deallocate(pointer, "operator delete");
+}
+
+void operator delete[](void *pointer) noexcept
+{
+	deallocate(pointer, "operator delete[]");
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+	deallocate(pointer, "operator delete");
+}
+
+void operator delete[](void *pointer, size_t) noexcept
+{
+	deallocate(pointer, "operator delete[]");
+}
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept
+{
+	deallocate(pointer, "operator delete");
+}
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept
+{
+	deallocate(pointer, "operator delete[]");
+}
+
+#endif
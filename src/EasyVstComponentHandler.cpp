@@ -0,0 +1,56 @@
+#include <EasyVstComponentHandler.h>
+#include <EasyVst.h>
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+
+IMPLEMENT_FUNKNOWN_METHODS(EasyVstComponentHandler, IComponentHandler, IComponentHandler::iid)
+
+EasyVstComponentHandler::EasyVstComponentHandler()
+{
+	FUNKNOWN_CTOR
+}
+
+EasyVstComponentHandler::~EasyVstComponentHandler()
+{}
+
+void EasyVstComponentHandler::setHost(EasyVst *host)
+{
+	_host = host;
+}
+
+int32 EasyVstComponentHandler::pendingRestartFlags() const
+{
+	return _restartFlags.load(std::memory_order_acquire);
+}
+
+int32 EasyVstComponentHandler::takeRestartFlags(int32 mask)
+{
+	return _restartFlags.fetch_and(~mask, std::memory_order_acq_rel) & mask;
+}
+
+tresult PLUGIN_API EasyVstComponentHandler::beginEdit(ParamID /*id*/)
+{
+	return kResultOk;
+}
+
+tresult PLUGIN_API EasyVstComponentHandler::performEdit(ParamID id, ParamValue valueNormalized)
+{
+	if (!_host) {
+		return kResultFalse;
+	}
+
+	_host->queueParameterChange(id, valueNormalized, _host->samplePosition());
+	return kResultOk;
+}
+
+tresult PLUGIN_API EasyVstComponentHandler::endEdit(ParamID /*id*/)
+{
+	return kResultOk;
+}
+
+tresult PLUGIN_API EasyVstComponentHandler::restartComponent(int32 flags)
+{
+	_restartFlags.fetch_or(flags, std::memory_order_acq_rel);
+	return kResultOk;
+}
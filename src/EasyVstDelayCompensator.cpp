@@ -0,0 +1,123 @@
+#include <EasyVstDelayCompensator.h>
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+
+EasyVstDelayCompensator::EasyVstDelayCompensator()
+{}
+
+EasyVstDelayCompensator::~EasyVstDelayCompensator()
+{}
+
+int EasyVstDelayCompensator::addPath(EasyVst *vst, int numChannels)
+{
+	Path path;
+	path.vst = vst;
+	path.numChannels = numChannels;
+	_paths.push_back(path);
+	return static_cast<int>(_paths.size()) - 1;
+}
+
+void EasyVstDelayCompensator::clear()
+{
+	_paths.clear();
+	_maxCompensation = 0;
+	_groupLatency = 0;
+	_mask = 0;
+}
+
+bool EasyVstDelayCompensator::prepare(int maxCompensation)
+{
+	if (maxCompensation < 0) {
+		_printError("Invalid maximum compensation");
+		return false;
+	}
+
+	size_t size = 1;
+	while (size < static_cast<size_t>(maxCompensation) + 1) {
+		size <<= 1;
+	}
+
+	_maxCompensation = maxCompensation;
+	_mask = size - 1;
+	for (Path &path : _paths) {
+		path.lines.assign(path.numChannels, std::vector<Sample64>(size, 0.0));
+		path.writePosition = 0;
+		path.delay = 0;
+	}
+
+	return update();
+}
+
+bool EasyVstDelayCompensator::update()
+{
+	int groupLatency = 0;
+	for (const Path &path : _paths) {
+		groupLatency = std::max(groupLatency, static_cast<int>(path.vst->latencySamples()));
+	}
+
+	// Paths whose plugins are more than maxCompensation apart from the slowest one stay partly uncompensated
+	bool compensated = true;
+	for (Path &path : _paths) {
+		int delay = groupLatency - static_cast<int>(path.vst->latencySamples());
+		if (delay > _maxCompensation) {
+			delay = _maxCompensation;
+			compensated = false;
+		}
+		path.delay = delay;
+	}
+	_groupLatency = groupLatency;
+
+	return compensated;
+}
+
+int EasyVstDelayCompensator::numPaths() const
+{
+	return static_cast<int>(_paths.size());
+}
+
+int EasyVstDelayCompensator::delay(int path) const
+{
+	return _paths[path].delay;
+}
+
+int EasyVstDelayCompensator::groupLatency() const
+{
+	return _groupLatency;
+}
+
+void EasyVstDelayCompensator::process(int path, Sample32 *const *channels, int numChannels, int numSamples)
+{
+	_process(_paths[path], channels, numChannels, numSamples);
+}
+
+void EasyVstDelayCompensator::process(int path, Sample64 *const *channels, int numChannels, int numSamples)
+{
+	_process(_paths[path], channels, numChannels, numSamples);
+}
+
+template <typename SampleType>
+void EasyVstDelayCompensator::_process(Path &path, SampleType *const *channels, int numChannels, int numSamples)
+{
+	if (path.lines.empty()) {
+		return;
+	}
+
+	// Lines are written even at zero delay so that a later increase reads recent audio, not stale samples
+	for (int ch = 0; ch < std::min(numChannels, path.numChannels); ++ch) {
+		std::vector<Sample64> &line = path.lines[ch];
+		SampleType *samples = channels[ch];
+		size_t position = path.writePosition;
+		for (int i = 0; i < numSamples; ++i) {
+			line[position] = samples[i];
+			samples[i] = static_cast<SampleType>(line[(position - path.delay) & _mask]);
+			position = (position + 1) & _mask;
+		}
+	}
+	path.writePosition = (path.writePosition + numSamples) & _mask;
+}
+
+void EasyVstDelayCompensator::_printError(const std::string &error)
+{
+	std::cerr << "EasyVstDelayCompensator error: " << error << std::endl;
+}
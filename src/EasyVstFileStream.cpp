@@ -0,0 +1,579 @@
+#include <EasyVstFileStream.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define EASYVST_FILESTREAM_MMAP
+#endif
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+
+static const uint16 WAV_FORMAT_PCM = 1;
+static const uint16 WAV_FORMAT_FLOAT = 3;
+static const uint16 WAV_FORMAT_EXTENSIBLE = 0xFFFE;
+static const size_t WAV_HEADER_SIZE = 44;
+static const uint32 WAV_SATURATED_SIZE = 0xFFFFFFFF;
+
+static uint16 readLE16(const char *data)
+{
+	const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+	return static_cast<uint16>(bytes[0] | (bytes[1] << 8));
+}
+
+static uint32 readLE32(const char *data)
+{
+	const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+	return static_cast<uint32>(bytes[0]) | (static_cast<uint32>(bytes[1]) << 8) | (static_cast<uint32>(bytes[2]) << 16) | (static_cast<uint32>(bytes[3]) << 24);
+}
+
+static void writeLE16(char *data, uint16 value)
+{
+	data[0] = static_cast<char>(value & 0xFF);
+	data[1] = static_cast<char>(value >> 8);
+}
+
+static void writeLE32(char *data, uint32 value)
+{
+	for (int i = 0; i < 4; ++i) {
+		data[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+	}
+}
+
+EasyVstFileReader::EasyVstFileReader()
+{}
+
+EasyVstFileReader::~EasyVstFileReader()
+{
+	close();
+}
+
+bool EasyVstFileReader::open(const std::string &path, size_t prefetchBytes, int maxBlockFrames)
+{
+	close();
+
+	if (!_map(path) || !_parseWav()) {
+		close();
+		return false;
+	}
+
+	_tail.reserve(static_cast<size_t>(std::max(maxBlockFrames, 1)) * _frameBytes);
+	return _startPrefetch(prefetchBytes);
+}
+
+bool EasyVstFileReader::openRaw(const std::string &path, EasyVstSampleFormat format, int channels, int sampleRate, size_t dataOffset, size_t prefetchBytes, int maxBlockFrames)
+{
+	close();
+
+	if (channels <= 0) {
+		_printError("Invalid channel count");
+		return false;
+	}
+	if (!_map(path)) {
+		close();
+		return false;
+	}
+	if (dataOffset > _mappingSize) {
+		_printError("Data offset lies beyond the end of \"" + path + "\"");
+		close();
+		return false;
+	}
+
+	_format = format;
+	_channels = channels;
+	_sampleRate = sampleRate;
+	_dataOffset = dataOffset;
+	_dataSize = _mappingSize - dataOffset;
+	_frameBytes = channels * EasyVstSampleConvert::bytesPerSample(format);
+	_numFrames = static_cast<int64>(_dataSize / _frameBytes);
+
+	_tail.reserve(static_cast<size_t>(std::max(maxBlockFrames, 1)) * _frameBytes);
+	return _startPrefetch(prefetchBytes);
+}
+
+void EasyVstFileReader::close()
+{
+	{
+		std::lock_guard<std::mutex> lock(_prefetchMutex);
+		_prefetchRunning = false;
+	}
+	_prefetchWake.notify_all();
+	if (_prefetchThread.joinable()) {
+		_prefetchThread.join();
+	}
+
+#ifdef EASYVST_FILESTREAM_MMAP
+	if (_mapping) {
+		munmap(const_cast<char *>(_mapping), _mappingSize);
+	}
+	if (_fd >= 0) {
+		::close(_fd);
+	}
+#endif
+	_fd = -1;
+	_mapping = nullptr;
+	_mappingSize = 0;
+	_dataOffset = 0;
+	_dataSize = 0;
+
+	_channels = 0;
+	_sampleRate = 0;
+	_frameBytes = 0;
+	_numFrames = 0;
+	_position.store(0);
+	_prefetchBytes = 0;
+	_prefetchHalfWindow = 0;
+	_tail.clear();
+	_path = "";
+}
+
+bool EasyVstFileReader::isOpen() const
+{
+	return _mapping != nullptr;
+}
+
+Steinberg::int64 EasyVstFileReader::numFrames() const
+{
+	return _numFrames;
+}
+
+Steinberg::int64 EasyVstFileReader::position() const
+{
+	return _position.load(std::memory_order_relaxed);
+}
+
+bool EasyVstFileReader::seek(Steinberg::int64 frame)
+{
+	if (!_mapping || frame < 0 || frame > _numFrames) {
+		_printError("Invalid seek position");
+		return false;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_prefetchMutex);
+		_position.store(frame, std::memory_order_release);
+	}
+	_prefetchWake.notify_one();
+	return true;
+}
+
+int EasyVstFileReader::channels() const
+{
+	return _channels;
+}
+
+int EasyVstFileReader::sampleRate() const
+{
+	return _sampleRate;
+}
+
+EasyVstSampleFormat EasyVstFileReader::format() const
+{
+	return _format;
+}
+
+int EasyVstFileReader::read(EasyVst &vst, int bus, int numFrames, float gain)
+{
+	if (!_mapping || numFrames <= 0) {
+		return 0;
+	}
+
+	int64 position = _position.load(std::memory_order_relaxed);
+	int frames = static_cast<int>(std::max<int64>(0, std::min<int64>(numFrames, _numFrames - position)));
+	const char *data = _mapping + _dataOffset + static_cast<size_t>(position) * _frameBytes;
+
+	bool success;
+	if (frames == numFrames) {
+		success = vst.copyFromInterleaved(bus, data, _format, _channels, numFrames, gain);
+	} else {
+		// Past the end of the file, pad the block with silence from a scratch copy; it was reserved in open()
+		// and only grows for blocks beyond maxBlockFrames
+		_tail.assign(static_cast<size_t>(numFrames) * _frameBytes, 0);
+		if (frames > 0) {
+			std::memcpy(_tail.data(), data, static_cast<size_t>(frames) * _frameBytes);
+		}
+		success = vst.copyFromInterleaved(bus, _tail.data(), _format, _channels, numFrames, gain);
+	}
+	if (!success) {
+		return 0;
+	}
+
+	// Wake the prefetch thread each time the read position has moved on by half a window
+	int64 next = position + frames;
+	if (_prefetchHalfWindow > 0 && next / _prefetchHalfWindow != position / _prefetchHalfWindow) {
+		{
+			std::lock_guard<std::mutex> lock(_prefetchMutex);
+			_position.store(next, std::memory_order_release);
+		}
+		_prefetchWake.notify_one();
+	} else {
+		_position.store(next, std::memory_order_release);
+	}
+
+	return frames;
+}
+
+bool EasyVstFileReader::_map(const std::string &path)
+{
+	_path = path;
+
+#ifdef EASYVST_FILESTREAM_MMAP
+	_fd = ::open(path.c_str(), O_RDONLY);
+	if (_fd < 0) {
+		_printError("Failed to open \"" + path + "\"");
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(_fd, &info) != 0 || info.st_size <= 0) {
+		_printError("\"" + path + "\" is empty or cannot be read");
+		return false;
+	}
+	_mappingSize = static_cast<size_t>(info.st_size);
+
+	void *mapping = mmap(nullptr, _mappingSize, PROT_READ, MAP_SHARED, _fd, 0);
+	if (mapping == MAP_FAILED) {
+		_mappingSize = 0;
+		_printError("Failed to map \"" + path + "\"");
+		return false;
+	}
+	_mapping = static_cast<const char *>(mapping);
+
+	// The kernel's own readahead is tuned for this access pattern; the prefetch thread extends it
+	madvise(mapping, _mappingSize, MADV_SEQUENTIAL);
+	return true;
+#else
+	_printError("Memory-mapped file streaming is not supported on this platform");
+	return false;
+#endif
+}
+
+bool EasyVstFileReader::_parseWav()
+{
+	if (_mappingSize < 12 || std::memcmp(_mapping, "RIFF", 4) != 0 || std::memcmp(_mapping + 8, "WAVE", 4) != 0) {
+		_printError("\"" + _path + "\" is not a WAV file");
+		return false;
+	}
+
+	uint16 formatTag = 0, bitsPerSample = 0;
+	bool hasFormat = false, hasData = false;
+	size_t offset = 12;
+	while (offset + 8 <= _mappingSize && !hasData) {
+		const char *chunk = _mapping + offset;
+		size_t chunkSize = readLE32(chunk + 4);
+		size_t body = offset + 8;
+
+		if (std::memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16 && body + 16 <= _mappingSize) {
+			formatTag = readLE16(_mapping + body);
+			_channels = readLE16(_mapping + body + 2);
+			_sampleRate = static_cast<int>(readLE32(_mapping + body + 4));
+			bitsPerSample = readLE16(_mapping + body + 14);
+			if (formatTag == WAV_FORMAT_EXTENSIBLE && chunkSize >= 40 && body + 26 <= _mappingSize) {
+				formatTag = readLE16(_mapping + body + 24);
+			}
+			hasFormat = true;
+		} else if (std::memcmp(chunk, "data", 4) == 0) {
+			// Saturated sizes from long recordings and zero sizes from unfinished ones mean "to the end of
+			// the file"; truncated sizes are clamped to what the file holds
+			size_t available = _mappingSize - std::min(body, _mappingSize);
+			_dataOffset = body;
+			_dataSize = (chunkSize == WAV_SATURATED_SIZE || chunkSize == 0) ? available : std::min(chunkSize, available);
+			hasData = true;
+		}
+
+		offset = body + chunkSize + (chunkSize & 1);
+	}
+
+	if (!hasFormat || !hasData || _channels <= 0) {
+		_printError("\"" + _path + "\" has no usable fmt or data chunk");
+		return false;
+	}
+
+	if (formatTag == WAV_FORMAT_PCM && bitsPerSample == 16) {
+		_format = EasyVstSampleFormat::kInt16;
+	} else if (formatTag == WAV_FORMAT_PCM && bitsPerSample == 24) {
+		_format = EasyVstSampleFormat::kInt24;
+	} else if (formatTag == WAV_FORMAT_PCM && bitsPerSample == 32) {
+		_format = EasyVstSampleFormat::kInt32;
+	} else if (formatTag == WAV_FORMAT_FLOAT && bitsPerSample == 32) {
+		_format = EasyVstSampleFormat::kFloat32;
+	} else {
+		_printError("\"" + _path + "\" uses an unsupported sample format");
+		return false;
+	}
+
+	_frameBytes = _channels * EasyVstSampleConvert::bytesPerSample(_format);
+	_numFrames = static_cast<int64>(_dataSize / _frameBytes);
+	return true;
+}
+
+bool EasyVstFileReader::_startPrefetch(size_t prefetchBytes)
+{
+	_prefetchBytes = prefetchBytes;
+	_prefetchHalfWindow = static_cast<int64>(prefetchBytes / 2 / _frameBytes);
+	if (_prefetchHalfWindow <= 0) {
+		_prefetchHalfWindow = 0;
+		return true;
+	}
+
+	_prefetchRunning = true;
+	_prefetchThread = std::thread(&EasyVstFileReader::_prefetchMain, this);
+	return true;
+}
+
+void EasyVstFileReader::_prefetchMain()
+{
+#ifdef EASYVST_FILESTREAM_MMAP
+	size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	size_t advisedEnd = 0, droppedEnd = 0;
+	char *mapping = const_cast<char *>(_mapping);
+
+	std::unique_lock<std::mutex> lock(_prefetchMutex);
+	while (_prefetchRunning) {
+		int64 position = _position.load(std::memory_order_acquire);
+		size_t cursor = _dataOffset + static_cast<size_t>(position) * _frameBytes;
+		size_t cursorPage = cursor / pageSize * pageSize;
+
+		// A backwards seek invalidates what has been advised and dropped so far
+		if (cursorPage < droppedEnd) {
+			droppedEnd = cursorPage;
+			advisedEnd = cursorPage;
+		}
+
+		lock.unlock();
+		size_t windowEnd = std::min(_mappingSize, cursor + _prefetchBytes);
+		if (windowEnd > advisedEnd) {
+			size_t start = std::max(advisedEnd, cursorPage) / pageSize * pageSize;
+			madvise(mapping + start, windowEnd - start, MADV_WILLNEED);
+			advisedEnd = windowEnd;
+		}
+		if (cursorPage > droppedEnd) {
+			madvise(mapping + droppedEnd, cursorPage - droppedEnd, MADV_DONTNEED);
+			droppedEnd = cursorPage;
+		}
+		lock.lock();
+
+		_prefetchWake.wait(lock, [this, position] {
+			int64 current = _position.load(std::memory_order_acquire);
+			return !_prefetchRunning || current < position || current / _prefetchHalfWindow != position / _prefetchHalfWindow;
+		});
+	}
+#endif
+}
+
+void EasyVstFileReader::_printError(const std::string &error)
+{
+	std::cerr << "EasyVstFileReader error: " << error << std::endl;
+}
+
+EasyVstFileWriter::EasyVstFileWriter()
+{}
+
+EasyVstFileWriter::~EasyVstFileWriter()
+{
+	close();
+}
+
+bool EasyVstFileWriter::open(const std::string &path, EasyVstFileContainer container, EasyVstSampleFormat format, int channels, int sampleRate, int bufferFrames)
+{
+	close();
+
+	if (channels <= 0 || bufferFrames <= 0) {
+		_printError("Invalid channel count or buffer size");
+		return false;
+	}
+
+	_file = std::fopen(path.c_str(), "wb");
+	if (!_file) {
+		_printError("Failed to create \"" + path + "\"");
+		return false;
+	}
+	// Writes already arrive in large blocks, stdio buffering would only add a copy
+	std::setvbuf(_file, nullptr, _IONBF, 0);
+
+	_container = container;
+	_format = format;
+	_channels = channels;
+	_sampleRate = sampleRate;
+	_frameBytes = channels * EasyVstSampleConvert::bytesPerSample(format);
+	_framesWritten = 0;
+	_failed.store(false);
+
+	if (_container == EasyVstFileContainer::kWav && !_writeWavHeader(0)) {
+		_printError("Failed to write WAV header to \"" + path + "\"");
+		std::fclose(_file);
+		_file = nullptr;
+		return false;
+	}
+
+	for (Buffer &buffer : _buffers) {
+		buffer.data.resize(static_cast<size_t>(bufferFrames) * _frameBytes);
+		buffer.used = 0;
+	}
+	_fillingBuffer = 0;
+
+	_pendingBuffer = nullptr;
+	_writerRunning = true;
+	_writerThread = std::thread(&EasyVstFileWriter::_writerMain, this);
+
+	return true;
+}
+
+bool EasyVstFileWriter::close()
+{
+	if (!_file) {
+		return false;
+	}
+
+	if (_buffers[_fillingBuffer].used > 0) {
+		_submit();
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(_writerMutex);
+		_writerDone.wait(lock, [this] { return _pendingBuffer == nullptr; });
+		_writerRunning = false;
+	}
+	_writerWake.notify_all();
+	if (_writerThread.joinable()) {
+		_writerThread.join();
+	}
+
+	if (_container == EasyVstFileContainer::kWav) {
+		uint64 dataBytes = static_cast<uint64>(_framesWritten) * _frameBytes;
+		if (!_writeWavHeader(dataBytes)) {
+			_printError("Failed to finalize WAV header");
+			_failed.store(true);
+		}
+	}
+
+	if (std::fclose(_file) != 0) {
+		_failed.store(true);
+	}
+	_file = nullptr;
+
+	for (Buffer &buffer : _buffers) {
+		buffer.data.clear();
+		buffer.data.shrink_to_fit();
+		buffer.used = 0;
+	}
+
+	return !_failed.load();
+}
+
+bool EasyVstFileWriter::isOpen() const
+{
+	return _file != nullptr;
+}
+
+Steinberg::int64 EasyVstFileWriter::framesWritten() const
+{
+	return _framesWritten;
+}
+
+bool EasyVstFileWriter::write(EasyVst &vst, int bus, int numFrames, float gain)
+{
+	if (!_file || numFrames <= 0) {
+		return false;
+	}
+
+	size_t bytes = static_cast<size_t>(numFrames) * _frameBytes;
+	if (bytes > _buffers[0].data.size()) {
+		_printError("Block is larger than the write buffer");
+		return false;
+	}
+
+	if (_buffers[_fillingBuffer].used + bytes > _buffers[_fillingBuffer].data.size() && !_submit()) {
+		return false;
+	}
+
+	Buffer &buffer = _buffers[_fillingBuffer];
+	if (!vst.copyToInterleaved(bus, buffer.data.data() + buffer.used, _format, _channels, numFrames, gain)) {
+		return false;
+	}
+	buffer.used += bytes;
+	_framesWritten += numFrames;
+
+	return !_failed.load(std::memory_order_relaxed);
+}
+
+bool EasyVstFileWriter::_submit()
+{
+	{
+		std::unique_lock<std::mutex> lock(_writerMutex);
+		_writerDone.wait(lock, [this] { return _pendingBuffer == nullptr; });
+		_pendingBuffer = &_buffers[_fillingBuffer];
+	}
+	_writerWake.notify_one();
+
+	_fillingBuffer ^= 1;
+	return !_failed.load();
+}
+
+void EasyVstFileWriter::_writerMain()
+{
+	while (true) {
+		Buffer *buffer = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(_writerMutex);
+			_writerWake.wait(lock, [this] { return _pendingBuffer != nullptr || !_writerRunning; });
+			if (!_pendingBuffer) {
+				break;
+			}
+			buffer = _pendingBuffer;
+		}
+
+		if (std::fwrite(buffer->data.data(), 1, buffer->used, _file) != buffer->used) {
+			_printError("Failed to write output file");
+			_failed.store(true);
+		}
+		buffer->used = 0;
+
+		{
+			std::lock_guard<std::mutex> lock(_writerMutex);
+			_pendingBuffer = nullptr;
+		}
+		_writerDone.notify_all();
+	}
+}
+
+bool EasyVstFileWriter::_writeWavHeader(Steinberg::uint64 dataBytes)
+{
+	uint32 dataSize = static_cast<uint32>(dataBytes);
+	uint32 riffSize = static_cast<uint32>(WAV_HEADER_SIZE - 8 + dataBytes);
+	if (dataBytes > WAV_SATURATED_SIZE - (WAV_HEADER_SIZE - 8)) {
+		_printError("Output exceeds the WAV size limit, header sizes are saturated");
+		dataSize = WAV_SATURATED_SIZE;
+		riffSize = WAV_SATURATED_SIZE;
+	}
+
+	int bitsPerSample = EasyVstSampleConvert::bytesPerSample(_format) * 8;
+
+	char header[WAV_HEADER_SIZE];
+	std::memcpy(header, "RIFF", 4);
+	writeLE32(header + 4, riffSize);
+	std::memcpy(header + 8, "WAVE", 4);
+	std::memcpy(header + 12, "fmt ", 4);
+	writeLE32(header + 16, 16);
+	writeLE16(header + 20, _format == EasyVstSampleFormat::kFloat32 ? WAV_FORMAT_FLOAT : WAV_FORMAT_PCM);
+	writeLE16(header + 22, static_cast<uint16>(_channels));
+	writeLE32(header + 24, static_cast<uint32>(_sampleRate));
+	writeLE32(header + 28, static_cast<uint32>(_sampleRate) * _frameBytes);
+	writeLE16(header + 32, static_cast<uint16>(_frameBytes));
+	writeLE16(header + 34, static_cast<uint16>(bitsPerSample));
+	std::memcpy(header + 36, "data", 4);
+	writeLE32(header + 40, dataSize);
+
+	return std::fseek(_file, 0, SEEK_SET) == 0 && std::fwrite(header, 1, WAV_HEADER_SIZE, _file) == WAV_HEADER_SIZE;
+}
+
+void EasyVstFileWriter::_printError(const std::string &error)
+{
+	std::cerr << "EasyVstFileWriter error: " << error << std::endl;
+}
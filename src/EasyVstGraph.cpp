@@ -0,0 +1,372 @@
+#include <EasyVstGraph.h>
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+
+template <typename DestType, typename SourceType>
+static void mixChannel(DestType *dest, const SourceType *source, int numSamples)
+{
+	for (int i = 0; i < numSamples; ++i) {
+		dest[i] += static_cast<DestType>(source[i]);
+	}
+}
+
+EasyVstGraph::EasyVstGraph()
+{}
+
+EasyVstGraph::~EasyVstGraph()
+{
+	clear();
+}
+
+int EasyVstGraph::addNode(EasyVst *vst)
+{
+	Node node;
+	node.vst = vst;
+	_nodes.push_back(node);
+	_prepared = false;
+	return static_cast<int>(_nodes.size()) - 1;
+}
+
+bool EasyVstGraph::connectAudio(int sourceNode, int sourceBus, int destNode, int destBus)
+{
+	if (sourceNode < 0 || sourceNode >= numNodes() || destNode < 0 || destNode >= numNodes() || sourceNode == destNode) {
+		_printError("Invalid audio connection nodes");
+		return false;
+	}
+	if (sourceBus < 0 || sourceBus >= _nodes[sourceNode].vst->numBuses(kAudio, kOutput) || destBus < 0 || destBus >= _nodes[destNode].vst->numBuses(kAudio, kInput)) {
+		_printError("Invalid audio connection buses");
+		return false;
+	}
+
+	Connection connection;
+	connection.sourceNode = sourceNode;
+	connection.sourceBus = sourceBus;
+	connection.destNode = destNode;
+	connection.destBus = destBus;
+	_audioConnections.push_back(connection);
+	_prepared = false;
+	return true;
+}
+
+bool EasyVstGraph::connectEvents(int sourceNode, int sourceBus, int destNode, int destBus)
+{
+	if (sourceNode < 0 || sourceNode >= numNodes() || destNode < 0 || destNode >= numNodes() || sourceNode == destNode) {
+		_printError("Invalid event connection nodes");
+		return false;
+	}
+	if (sourceBus < 0 || sourceBus >= _nodes[sourceNode].vst->numBuses(kEvent, kOutput) || destBus < 0 || destBus >= _nodes[destNode].vst->numBuses(kEvent, kInput)) {
+		_printError("Invalid event connection buses");
+		return false;
+	}
+
+	Connection connection;
+	connection.sourceNode = sourceNode;
+	connection.sourceBus = sourceBus;
+	connection.destNode = destNode;
+	connection.destBus = destBus;
+	_eventConnections.push_back(connection);
+	_prepared = false;
+	return true;
+}
+
+void EasyVstGraph::clear()
+{
+	_unbind();
+	_nodes.clear();
+	_audioConnections.clear();
+	_eventConnections.clear();
+	_order.clear();
+}
+
+bool EasyVstGraph::prepare()
+{
+	_unbind();
+
+	for (Node &node : _nodes) {
+		node.audioInputs.clear();
+		node.eventInput = {};
+		node.successors.clear();
+		node.numPredecessors = 0;
+	}
+
+	for (const Connection &connection : _audioConnections) {
+		Node &dest = _nodes[connection.destNode];
+		auto it = std::find_if(dest.audioInputs.begin(), dest.audioInputs.end(), [&](const AudioInput &input) {
+			return input.destBus == connection.destBus;
+		});
+		if (it == dest.audioInputs.end()) {
+			AudioInput input;
+			input.destBus = connection.destBus;
+			dest.audioInputs.push_back(input);
+			it = dest.audioInputs.end() - 1;
+		}
+		it->sources.push_back(connection);
+	}
+
+	for (const Connection &connection : _eventConnections) {
+		_nodes[connection.destNode].eventInput.sources.push_back(connection);
+	}
+
+	for (const Connection &connection : _audioConnections) {
+		_nodes[connection.sourceNode].successors.push_back(connection.destNode);
+	}
+	for (const Connection &connection : _eventConnections) {
+		_nodes[connection.sourceNode].successors.push_back(connection.destNode);
+	}
+	for (Node &node : _nodes) {
+		std::sort(node.successors.begin(), node.successors.end());
+		node.successors.erase(std::unique(node.successors.begin(), node.successors.end()), node.successors.end());
+		for (int successor : node.successors) {
+			++_nodes[successor].numPredecessors;
+		}
+	}
+
+	if (!_sortNodes()) {
+		_printError("Graph contains a cycle");
+		return false;
+	}
+
+	for (Node &node : _nodes) {
+		EasyVst *dest = node.vst;
+		node.bufferGeneration = dest->_bufferGeneration;
+
+		for (AudioInput &input : node.audioInputs) {
+			if (input.sources.size() != 1) {
+				continue;
+			}
+
+			const Connection &connection = input.sources[0];
+			EasyVst *source = _nodes[connection.sourceNode].vst;
+			const AudioBusBuffers &sourceBus = source->_hostBuses(kOutput)[connection.sourceBus];
+			const AudioBusBuffers &destBus = dest->_hostBuses(kInput)[input.destBus];
+			if (sourceBus.numChannels != destBus.numChannels || source->_symbolicSampleSize != dest->_symbolicSampleSize || source->_maxBlockSize < dest->_maxBlockSize) {
+				continue;
+			}
+
+			std::vector<void *> channelBuffers(sourceBus.numChannels);
+			for (int i = 0; i < sourceBus.numChannels; ++i) {
+				channelBuffers[i] = source->_channelBuffer(kOutput, connection.sourceBus, i);
+			}
+			dest->_shareInputBus(input.destBus, channelBuffers.data());
+			input.shared = true;
+		}
+
+		// Events are forwarded by pointer only when the source's whole output list belongs to this bus.
+		EventInput &eventInput = node.eventInput;
+		if (eventInput.sources.size() == 1) {
+			const Connection &connection = eventInput.sources[0];
+			EasyVst *source = _nodes[connection.sourceNode].vst;
+			if (source->numBuses(kEvent, kOutput) == 1 && connection.sourceBus == connection.destBus) {
+				dest->_bindInputEvents(source->_outEventLists);
+				eventInput.shared = true;
+			}
+		}
+	}
+
+	_prepared = true;
+	return true;
+}
+
+bool EasyVstGraph::process(int numSamples)
+{
+	if (!_prepared) {
+		_printError("process() called before prepare()");
+		return false;
+	}
+
+	bool success = true;
+	for (int index : _order) {
+		if (!processNode(index, numSamples)) {
+			success = false;
+		}
+	}
+
+	return success;
+}
+
+bool EasyVstGraph::processNode(int index, int numSamples)
+{
+	Node &node = _nodes[index];
+	if (!_isCurrent(node)) {
+		_printError("A connected instance was reconfigured or re-initialized, call prepare() again");
+		return false;
+	}
+
+	for (AudioInput &input : node.audioInputs) {
+		_pullAudioInput(node, input, numSamples);
+	}
+	_pullEvents(node);
+
+	return node.vst->process(numSamples);
+}
+
+bool EasyVstGraph::isPrepared() const
+{
+	return _prepared;
+}
+
+int EasyVstGraph::numNodes() const
+{
+	return static_cast<int>(_nodes.size());
+}
+
+EasyVst *EasyVstGraph::node(int index) const
+{
+	return _nodes[index].vst;
+}
+
+const std::vector<int> &EasyVstGraph::successors(int index) const
+{
+	return _nodes[index].successors;
+}
+
+int EasyVstGraph::numPredecessors(int index) const
+{
+	return _nodes[index].numPredecessors;
+}
+
+const std::vector<int> &EasyVstGraph::processingOrder() const
+{
+	return _order;
+}
+
+void EasyVstGraph::_unbind()
+{
+	for (Node &node : _nodes) {
+		for (AudioInput &input : node.audioInputs) {
+			if (input.shared) {
+				node.vst->_unshareInputBus(input.destBus);
+				input.shared = false;
+			}
+		}
+		if (node.eventInput.shared) {
+			node.vst->_bindInputEvents(nullptr);
+			node.eventInput.shared = false;
+		}
+	}
+	_prepared = false;
+}
+
+bool EasyVstGraph::_sortNodes()
+{
+	_order.clear();
+	_order.reserve(_nodes.size());
+
+	std::vector<int> pending(_nodes.size());
+	for (size_t i = 0; i < _nodes.size(); ++i) {
+		pending[i] = _nodes[i].numPredecessors;
+		if (pending[i] == 0) {
+			_order.push_back(static_cast<int>(i));
+		}
+	}
+
+	for (size_t i = 0; i < _order.size(); ++i) {
+		for (int successor : _nodes[_order[i]].successors) {
+			if (--pending[successor] == 0) {
+				_order.push_back(successor);
+			}
+		}
+	}
+
+	return _order.size() == _nodes.size();
+}
+
+bool EasyVstGraph::_isCurrent(const Node &node) const
+{
+	if (node.vst->_bufferGeneration != node.bufferGeneration) {
+		return false;
+	}
+	for (const AudioInput &input : node.audioInputs) {
+		for (const Connection &connection : input.sources) {
+			const Node &source = _nodes[connection.sourceNode];
+			if (source.vst->_bufferGeneration != source.bufferGeneration) {
+				return false;
+			}
+		}
+	}
+	for (const Connection &connection : node.eventInput.sources) {
+		const Node &source = _nodes[connection.sourceNode];
+		if (source.vst->_bufferGeneration != source.bufferGeneration) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void EasyVstGraph::_pullAudioInput(Node &node, AudioInput &input, int numSamples)
+{
+	EasyVst *dest = node.vst;
+	AudioBusBuffers &destBus = dest->_hostBuses(kInput)[input.destBus];
+
+	if (input.shared) {
+		const Connection &connection = input.sources[0];
+		const AudioBusBuffers &sourceBus = _nodes[connection.sourceNode].vst->_hostBuses(kOutput)[connection.sourceBus];
+		destBus.silenceFlags = sourceBus.silenceFlags;
+		return;
+	}
+
+	// Fan-in and mismatched layouts are mixed into the destination's own input buffers
+	bool dest64 = dest->_symbolicSampleSize == kSample64;
+	for (int i = 0; i < destBus.numChannels; ++i) {
+		if (dest64) {
+			std::fill(destBus.channelBuffers64[i], destBus.channelBuffers64[i] + numSamples, 0.0);
+		} else {
+			std::fill(destBus.channelBuffers32[i], destBus.channelBuffers32[i] + numSamples, 0.0f);
+		}
+	}
+	destBus.silenceFlags = 0;
+
+	for (const Connection &connection : input.sources) {
+		EasyVst *source = _nodes[connection.sourceNode].vst;
+		const AudioBusBuffers &sourceBus = source->_hostBuses(kOutput)[connection.sourceBus];
+		bool source64 = source->_symbolicSampleSize == kSample64;
+		int numChannels = std::min(sourceBus.numChannels, destBus.numChannels);
+		for (int i = 0; i < numChannels; ++i) {
+			if (dest64 && source64) {
+				mixChannel(destBus.channelBuffers64[i], sourceBus.channelBuffers64[i], numSamples);
+			} else if (dest64) {
+				mixChannel(destBus.channelBuffers64[i], sourceBus.channelBuffers32[i], numSamples);
+			} else if (source64) {
+				mixChannel(destBus.channelBuffers32[i], sourceBus.channelBuffers64[i], numSamples);
+			} else {
+				mixChannel(destBus.channelBuffers32[i], sourceBus.channelBuffers32[i], numSamples);
+			}
+		}
+	}
+}
+
+void EasyVstGraph::_pullEvents(Node &node)
+{
+	EventInput &eventInput = node.eventInput;
+	if (eventInput.shared || eventInput.sources.empty()) {
+		return;
+	}
+
+	// Events the caller added to the list for this block are kept alongside the forwarded ones
+	EventList *destEvents = node.vst->_inEventLists;
+	bool hadEvents = destEvents->getEventCount() > 0;
+
+	for (const Connection &connection : eventInput.sources) {
+		EventList *sourceEvents = _nodes[connection.sourceNode].vst->_outEventLists;
+		int numEvents = sourceEvents->getEventCount();
+		for (int i = 0; i < numEvents; ++i) {
+			Event event = *sourceEvents->getEventByIndex(i);
+			if (event.busIndex != connection.sourceBus) {
+				continue;
+			}
+			event.busIndex = connection.destBus;
+			destEvents->addEvent(event);
+		}
+	}
+
+	// Each source's events are in order, but fan-in and caller events interleave them
+	if (eventInput.sources.size() > 1 || hadEvents) {
+		EasyVst::_sortEvents(*destEvents);
+	}
+}
+
+void EasyVstGraph::_printError(const std::string &error)
+{
+	std::cerr << "EasyVstGraph error: " << error << std::endl;
+}
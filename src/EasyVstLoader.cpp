@@ -0,0 +1,164 @@
+#include <EasyVstLoader.h>
+
+#include <algorithm>
+#include <iostream>
+
+EasyVstLoader::EasyVstLoader()
+{}
+
+EasyVstLoader::~EasyVstLoader()
+{
+	stop();
+}
+
+bool EasyVstLoader::start(int numThreads)
+{
+	stop();
+
+	if (numThreads < 1) {
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	_running = true;
+	for (int i = 0; i < numThreads; ++i) {
+		_workers.emplace_back(&EasyVstLoader::_workerMain, this);
+	}
+
+	return true;
+}
+
+void EasyVstLoader::stop()
+{
+	if (_workers.empty()) {
+		return;
+	}
+
+	wait();
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_running = false;
+	}
+	_taskAvailable.notify_all();
+
+	for (auto &worker : _workers) {
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+	_workers.clear();
+}
+
+void EasyVstLoader::pinToMainThread(const std::string &path)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_mainThreadPaths.insert(path);
+}
+
+std::future<bool> EasyVstLoader::submit(EasyVstLoadRequest request)
+{
+	if (!request.vst) {
+		_printError("Load request has no EasyVst instance");
+		std::promise<bool> failed;
+		failed.set_value(false);
+		return failed.get_future();
+	}
+
+	std::packaged_task<bool()> task([request] {
+		bool success = request.vst->init(request.path, request.classIdOrName, request.sampleRate, request.maxBlockSize, request.symbolicSampleSize, request.realtime);
+		if (request.done) {
+			request.done(*request.vst, success);
+		}
+		return success;
+	});
+	std::future<bool> result = task.get_future();
+
+	bool mainThread = false;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		mainThread = request.mainThread || _mainThreadPaths.count(request.path) > 0;
+		if (!mainThread && _workers.empty()) {
+			_printError("Loader is not started, loading \"" + request.path + "\" on the main thread");
+			mainThread = true;
+		}
+		(mainThread ? _mainThreadTasks : _tasks).push_back(std::move(task));
+		++_pendingTasks;
+	}
+
+	if (mainThread) {
+		_progress.notify_all();
+	} else {
+		_taskAvailable.notify_one();
+	}
+
+	return result;
+}
+
+int EasyVstLoader::runMainThreadTasks()
+{
+	int count = 0;
+	while (true) {
+		std::packaged_task<bool()> task;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (_mainThreadTasks.empty()) {
+				break;
+			}
+			task = std::move(_mainThreadTasks.front());
+			_mainThreadTasks.pop_front();
+		}
+
+		task();
+		++count;
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			--_pendingTasks;
+		}
+		_progress.notify_all();
+	}
+
+	return count;
+}
+
+void EasyVstLoader::wait()
+{
+	while (true) {
+		runMainThreadTasks();
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		_progress.wait(lock, [this] { return _pendingTasks == 0 || !_mainThreadTasks.empty(); });
+		if (_pendingTasks == 0) {
+			break;
+		}
+	}
+}
+
+void EasyVstLoader::_workerMain()
+{
+	while (true) {
+		std::packaged_task<bool()> task;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_taskAvailable.wait(lock, [this] { return !_tasks.empty() || !_running; });
+			if (_tasks.empty()) {
+				break;
+			}
+			task = std::move(_tasks.front());
+			_tasks.pop_front();
+		}
+
+		task();
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			--_pendingTasks;
+		}
+		_progress.notify_all();
+	}
+}
+
+void EasyVstLoader::_printError(const std::string &error)
+{
+	std::cerr << "EasyVstLoader error: " << error << std::endl;
+}
@@ -0,0 +1,142 @@
+#include <EasyVstMetrics.h>
+
+#include <algorithm>
+
+using namespace Steinberg;
+
+EasyVstMetrics::EasyVstMetrics()
+{
+	_clear();
+}
+
+void EasyVstMetrics::record(int64 durationNs, int64 deadlineNs, bool failed)
+{
+	// Only the audio thread writes, so a reset requested elsewhere is carried out here
+	if (_resetRequested.exchange(false, std::memory_order_acquire)) {
+		_clear();
+	}
+
+	durationNs = std::max<int64>(durationNs, 0);
+
+	uint64 calls = _calls.load(std::memory_order_relaxed);
+	_buckets[_bucketIndex(durationNs)].fetch_add(1, std::memory_order_relaxed);
+	if (calls == 0 || durationNs < _minNs.load(std::memory_order_relaxed)) {
+		_minNs.store(durationNs, std::memory_order_relaxed);
+	}
+	if (durationNs > _maxNs.load(std::memory_order_relaxed)) {
+		_maxNs.store(durationNs, std::memory_order_relaxed);
+	}
+
+	if (failed) {
+		_failures.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	if (deadlineNs > 0) {
+		double load = static_cast<double>(durationNs) / deadlineNs;
+		_lastLoad.store(load, std::memory_order_relaxed);
+		if (load > _peakLoad.load(std::memory_order_relaxed)) {
+			_peakLoad.store(load, std::memory_order_relaxed);
+		}
+		if (durationNs > deadlineNs) {
+			_overruns.fetch_add(1, std::memory_order_relaxed);
+		}
+		_totalNs.fetch_add(durationNs, std::memory_order_relaxed);
+		_totalDeadlineNs.fetch_add(deadlineNs, std::memory_order_relaxed);
+	}
+
+	_calls.store(calls + 1, std::memory_order_release);
+}
+
+void EasyVstMetrics::reset()
+{
+	_resetRequested.store(true, std::memory_order_release);
+}
+
+EasyVstProcessStats EasyVstMetrics::stats() const
+{
+	EasyVstProcessStats stats;
+	stats.calls = _calls.load(std::memory_order_acquire);
+	stats.failures = _failures.load(std::memory_order_relaxed);
+	stats.overruns = _overruns.load(std::memory_order_relaxed);
+	stats.minNs = _minNs.load(std::memory_order_relaxed);
+	stats.maxNs = _maxNs.load(std::memory_order_relaxed);
+	stats.lastLoad = _lastLoad.load(std::memory_order_relaxed);
+	stats.peakLoad = _peakLoad.load(std::memory_order_relaxed);
+
+	int64 totalDeadlineNs = _totalDeadlineNs.load(std::memory_order_relaxed);
+	if (totalDeadlineNs > 0) {
+		stats.averageLoad = static_cast<double>(_totalNs.load(std::memory_order_relaxed)) / totalDeadlineNs;
+	}
+
+	// The buckets are read one by one while the audio thread may still be adding to them, so the
+	// percentiles are taken over the counts actually seen rather than over stats.calls
+	uint64 counts[NUM_BUCKETS];
+	uint64 total = 0;
+	for (int i = 0; i < NUM_BUCKETS; ++i) {
+		counts[i] = _buckets[i].load(std::memory_order_relaxed);
+		total += counts[i];
+	}
+
+	if (total > 0) {
+		uint64 p50Rank = (total + 1) / 2;
+		uint64 p99Rank = std::max<uint64>((total * 99 + 99) / 100, 1);
+		uint64 seen = 0;
+		bool foundP50 = false;
+		for (int i = 0; i < NUM_BUCKETS; ++i) {
+			seen += counts[i];
+			if (!foundP50 && seen >= p50Rank) {
+				stats.p50Ns = std::min(_bucketUpperBound(i), stats.maxNs);
+				foundP50 = true;
+			}
+			if (seen >= p99Rank) {
+				stats.p99Ns = std::min(_bucketUpperBound(i), stats.maxNs);
+				break;
+			}
+		}
+	}
+
+	return stats;
+}
+
+int EasyVstMetrics::_bucketIndex(int64 durationNs)
+{
+	if (durationNs < NUM_LINEAR_BUCKETS) {
+		return static_cast<int>(durationNs);
+	}
+
+	int exponent = 63 - __builtin_clzll(static_cast<unsigned long long>(durationNs));
+	if (exponent > MAX_EXPONENT) {
+		return NUM_BUCKETS - 1;
+	}
+
+	int subBucket = static_cast<int>((durationNs >> (exponent - 3)) & (SUB_BUCKETS - 1));
+	return NUM_LINEAR_BUCKETS + (exponent - 4) * SUB_BUCKETS + subBucket;
+}
+
+int64 EasyVstMetrics::_bucketUpperBound(int index)
+{
+	if (index < NUM_LINEAR_BUCKETS) {
+		return index;
+	}
+
+	int exponent = (index - NUM_LINEAR_BUCKETS) / SUB_BUCKETS + 4;
+	int subBucket = (index - NUM_LINEAR_BUCKETS) % SUB_BUCKETS;
+	int64 width = int64(1) << (exponent - 3);
+	return (SUB_BUCKETS + subBucket) * width + width - 1;
+}
+
+void EasyVstMetrics::_clear()
+{
+	for (auto &bucket : _buckets) {
+		bucket.store(0, std::memory_order_relaxed);
+	}
+	_calls.store(0, std::memory_order_relaxed);
+	_failures.store(0, std::memory_order_relaxed);
+	_overruns.store(0, std::memory_order_relaxed);
+	_minNs.store(0, std::memory_order_relaxed);
+	_maxNs.store(0, std::memory_order_relaxed);
+	_totalNs.store(0, std::memory_order_relaxed);
+	_totalDeadlineNs.store(0, std::memory_order_relaxed);
+	_lastLoad.store(0.0, std::memory_order_relaxed);
+	_peakLoad.store(0.0, std::memory_order_relaxed);
+}
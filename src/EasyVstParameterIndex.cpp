@@ -0,0 +1,250 @@
+#include <EasyVstParameterIndex.h>
+
+#include <public.sdk/source/vst/utility/stringconvert.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+
+namespace {
+const ParamValue CONVERSION_SAMPLES[] = {0.0, 0.1, 0.25, 0.4, 0.5, 0.6, 0.75, 0.9, 1.0};
+const ParamValue CONVERSION_TOLERANCE = 1e-9;
+
+bool nearlyEqual(ParamValue a, ParamValue b, ParamValue scale)
+{
+	return std::fabs(a - b) <= CONVERSION_TOLERANCE * std::max<ParamValue>(1.0, std::fabs(scale));
+}
+}
+
+bool EasyVstParameter::canAutomate() const
+{
+	return flags & ParameterInfo::kCanAutomate;
+}
+
+bool EasyVstParameter::isReadOnly() const
+{
+	return flags & ParameterInfo::kIsReadOnly;
+}
+
+bool EasyVstParameter::isBypass() const
+{
+	return flags & ParameterInfo::kIsBypass;
+}
+
+bool EasyVstParameter::isList() const
+{
+	return flags & ParameterInfo::kIsList;
+}
+
+bool EasyVstParameter::isProgramChange() const
+{
+	return flags & ParameterInfo::kIsProgramChange;
+}
+
+EasyVstParameterIndex::EasyVstParameterIndex()
+{}
+
+EasyVstParameterIndex::~EasyVstParameterIndex()
+{}
+
+bool EasyVstParameterIndex::build(IEditController *controller)
+{
+	_parameters.clear();
+	_idSlots.clear();
+	_titleSlots.clear();
+	_mask = 0;
+
+	if (!controller) {
+		_printError("No edit controller");
+		return false;
+	}
+
+	int32 count = controller->getParameterCount();
+	_parameters.reserve(std::max(count, 0));
+	for (int32 i = 0; i < count; ++i) {
+		ParameterInfo info = {};
+		if (controller->getParameterInfo(i, info) != kResultOk) {
+			_printError("Failed to get info for parameter " + std::to_string(i));
+			continue;
+		}
+
+		EasyVstParameter parameter;
+		parameter.id = info.id;
+		parameter.title = VST3::StringConvert::convert(info.title);
+		parameter.shortTitle = VST3::StringConvert::convert(info.shortTitle);
+		parameter.units = VST3::StringConvert::convert(info.units);
+		parameter.stepCount = info.stepCount;
+		parameter.defaultNormalizedValue = info.defaultNormalizedValue;
+		parameter.unitId = info.unitId;
+		parameter.flags = info.flags;
+		parameter.minPlain = controller->normalizedParamToPlain(info.id, 0.0);
+		parameter.maxPlain = controller->normalizedParamToPlain(info.id, 1.0);
+		parameter.conversion = _detectConversion(controller, parameter);
+		_parameters.push_back(std::move(parameter));
+	}
+
+	// Power-of-two tables at most half full keep probe sequences short
+	size_t capacity = 8;
+	while (capacity < _parameters.size() * 2) {
+		capacity *= 2;
+	}
+	_mask = capacity - 1;
+	_idSlots.assign(capacity, -1);
+	_titleSlots.assign(capacity, -1);
+
+	for (int i = 0; i < static_cast<int>(_parameters.size()); ++i) {
+		const EasyVstParameter &parameter = _parameters[i];
+
+		size_t slot = _hash(parameter.id) & _mask;
+		while (_idSlots[slot] >= 0 && _parameters[_idSlots[slot]].id != parameter.id) {
+			slot = (slot + 1) & _mask;
+		}
+		if (_idSlots[slot] < 0) {
+			_idSlots[slot] = i;
+		}
+
+		// The first parameter with a given title wins, matching a linear search over the controller
+		slot = _hash(parameter.title) & _mask;
+		while (_titleSlots[slot] >= 0 && _parameters[_titleSlots[slot]].title != parameter.title) {
+			slot = (slot + 1) & _mask;
+		}
+		if (_titleSlots[slot] < 0) {
+			_titleSlots[slot] = i;
+		}
+	}
+
+	return true;
+}
+
+int EasyVstParameterIndex::count() const
+{
+	return static_cast<int>(_parameters.size());
+}
+
+const EasyVstParameter &EasyVstParameterIndex::at(int index) const
+{
+	return _parameters[index];
+}
+
+const EasyVstParameter *EasyVstParameterIndex::find(ParamID id) const
+{
+	if (_idSlots.empty()) {
+		return nullptr;
+	}
+
+	for (size_t slot = _hash(id) & _mask; _idSlots[slot] >= 0; slot = (slot + 1) & _mask) {
+		const EasyVstParameter &parameter = _parameters[_idSlots[slot]];
+		if (parameter.id == id) {
+			return &parameter;
+		}
+	}
+
+	return nullptr;
+}
+
+const EasyVstParameter *EasyVstParameterIndex::find(const std::string &title) const
+{
+	if (_titleSlots.empty()) {
+		return nullptr;
+	}
+
+	for (size_t slot = _hash(title) & _mask; _titleSlots[slot] >= 0; slot = (slot + 1) & _mask) {
+		const EasyVstParameter &parameter = _parameters[_titleSlots[slot]];
+		if (parameter.title == title) {
+			return &parameter;
+		}
+	}
+
+	return nullptr;
+}
+
+ParamValue EasyVstParameterIndex::toPlain(const EasyVstParameter &parameter, ParamValue normalized, IEditController *controller) const
+{
+	if (parameter.conversion == EasyVstParameter::Conversion::kController) {
+		return controller ? controller->normalizedParamToPlain(parameter.id, normalized) : normalized;
+	}
+
+	return _formulaToPlain(parameter, parameter.conversion, std::min(std::max(normalized, 0.0), 1.0));
+}
+
+ParamValue EasyVstParameterIndex::toNormalized(const EasyVstParameter &parameter, ParamValue plain, IEditController *controller) const
+{
+	if (parameter.conversion == EasyVstParameter::Conversion::kController) {
+		return controller ? controller->plainParamToNormalized(parameter.id, plain) : plain;
+	}
+
+	return std::min(std::max(_formulaToNormalized(parameter, plain), 0.0), 1.0);
+}
+
+EasyVstParameter::Conversion EasyVstParameterIndex::_detectConversion(IEditController *controller, const EasyVstParameter &parameter)
+{
+	ParamValue range = parameter.maxPlain - parameter.minPlain;
+	if (!std::isfinite(range) || range == 0.0) {
+		return EasyVstParameter::Conversion::kController;
+	}
+
+	// Stepped parameters in the SDK also map linearly when they leave toPlain() unimplemented, so try both
+	const EasyVstParameter::Conversion candidates[] = {EasyVstParameter::Conversion::kStepped, EasyVstParameter::Conversion::kLinear};
+	for (EasyVstParameter::Conversion conversion : candidates) {
+		if (conversion == EasyVstParameter::Conversion::kStepped && parameter.stepCount <= 0) {
+			continue;
+		}
+
+		bool matches = true;
+		for (ParamValue normalized : CONVERSION_SAMPLES) {
+			ParamValue plain = _formulaToPlain(parameter, conversion, normalized);
+			if (!nearlyEqual(controller->normalizedParamToPlain(parameter.id, normalized), plain, range)
+				|| !nearlyEqual(controller->plainParamToNormalized(parameter.id, plain), _formulaToNormalized(parameter, plain), 1.0)) {
+				matches = false;
+				break;
+			}
+		}
+
+		if (matches) {
+			return conversion;
+		}
+	}
+
+	return EasyVstParameter::Conversion::kController;
+}
+
+ParamValue EasyVstParameterIndex::_formulaToPlain(const EasyVstParameter &parameter, EasyVstParameter::Conversion conversion, ParamValue normalized)
+{
+	ParamValue range = parameter.maxPlain - parameter.minPlain;
+	if (conversion == EasyVstParameter::Conversion::kStepped) {
+		ParamValue step = std::floor(std::min<ParamValue>(parameter.stepCount, normalized * (parameter.stepCount + 1)));
+		return parameter.minPlain + step * range / parameter.stepCount;
+	}
+
+	return parameter.minPlain + normalized * range;
+}
+
+ParamValue EasyVstParameterIndex::_formulaToNormalized(const EasyVstParameter &parameter, ParamValue plain)
+{
+	// Both formulas invert the same way, a stepped value maps to step / stepCount
+	return (plain - parameter.minPlain) / (parameter.maxPlain - parameter.minPlain);
+}
+
+size_t EasyVstParameterIndex::_hash(ParamID id)
+{
+	// Fibonacci hashing, IDs are often small or sequential
+	return static_cast<size_t>((static_cast<uint64>(id) * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+size_t EasyVstParameterIndex::_hash(const std::string &title)
+{
+	// FNV-1a
+	uint64 hash = 0xcbf29ce484222325ull;
+	for (unsigned char c : title) {
+		hash = (hash ^ c) * 0x100000001b3ull;
+	}
+	return static_cast<size_t>(hash ^ (hash >> 32));
+}
+
+void EasyVstParameterIndex::_printError(const std::string &error) const
+{
+	std::cerr << "EasyVstParameterIndex error: " << error << std::endl;
+}
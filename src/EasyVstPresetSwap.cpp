@@ -0,0 +1,111 @@
+#include <EasyVstPresetSwap.h>
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+
+EasyVstPresetSwap::EasyVstPresetSwap()
+{}
+
+EasyVstPresetSwap::~EasyVstPresetSwap()
+{
+	destroy();
+}
+
+bool EasyVstPresetSwap::init(const std::string &path, const std::string &classIdOrName, int sampleRate, int maxBlockSize, int symbolicSampleSize, bool realtime)
+{
+	destroy();
+
+	for (EasyVst &instance : _instances) {
+		if (!instance.init(path, classIdOrName, sampleRate, maxBlockSize, symbolicSampleSize, realtime)) {
+			destroy();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void EasyVstPresetSwap::destroy()
+{
+	_instances[0].destroy();
+	_instances[1].destroy();
+	_active.store(0, std::memory_order_relaxed);
+	_swapPending.store(false, std::memory_order_relaxed);
+}
+
+void EasyVstPresetSwap::setProcessing(bool processing)
+{
+	_instances[0].setProcessing(processing);
+	_instances[1].setProcessing(processing);
+}
+
+bool EasyVstPresetSwap::prepareSwap(EasyVstState &state)
+{
+	if (_swapPending.load(std::memory_order_acquire)) {
+		_printError("Previous swap has not been picked up by the audio thread yet");
+		return false;
+	}
+
+	if (!standby()->loadState(state)) {
+		return false;
+	}
+
+	_swapPending.store(true, std::memory_order_release);
+	return true;
+}
+
+bool EasyVstPresetSwap::swapPending() const
+{
+	return _swapPending.load(std::memory_order_acquire);
+}
+
+EasyVst *EasyVstPresetSwap::beginBlock()
+{
+	int current = _active.load(std::memory_order_relaxed);
+	if (!_swapPending.load(std::memory_order_acquire)) {
+		return &_instances[current];
+	}
+
+	EasyVst &previous = _instances[current];
+	EasyVst &next = _instances[1 - current];
+	next._processContext = previous._processContext;
+	next._samplePosition.store(previous._samplePosition.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+	// Automation still queued on the outgoing instance carries over; it lands in the incoming instance's
+	// pending list, which only the audio thread touches and which is reserved up front
+	auto forward = [&next](const EasyVst::ParameterChangePoint &change) {
+		if (next._pendingParameterChanges.size() < next._pendingParameterChanges.capacity()) {
+			next._pendingParameterChanges.push_back(change);
+		} else {
+			next._parameterQueueOverflows.fetch_add(1, std::memory_order_relaxed);
+		}
+	};
+	for (const EasyVst::ParameterChangePoint &change : previous._pendingParameterChanges) {
+		forward(change);
+	}
+	previous._pendingParameterChanges.clear();
+	EasyVst::ParameterChangePoint change;
+	while (previous._parameterQueue.pop(change)) {
+		forward(change);
+	}
+
+	_active.store(1 - current, std::memory_order_relaxed);
+	_swapPending.store(false, std::memory_order_release);
+
+	return &next;
+}
+
+EasyVst *EasyVstPresetSwap::active()
+{
+	return &_instances[_active.load(std::memory_order_acquire)];
+}
+
+EasyVst *EasyVstPresetSwap::standby()
+{
+	return &_instances[1 - _active.load(std::memory_order_acquire)];
+}
+
+void EasyVstPresetSwap::_printError(const std::string &error)
+{
+	std::cerr << "EasyVstPresetSwap error: " << error << std::endl;
+}
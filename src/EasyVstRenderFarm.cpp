@@ -0,0 +1,207 @@
+#include <EasyVstRenderFarm.h>
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+
+EasyVstRenderFarm::EasyVstRenderFarm()
+{}
+
+EasyVstRenderFarm::~EasyVstRenderFarm()
+{
+	stop();
+}
+
+void EasyVstRenderFarm::preload(const std::string &path, const std::string &classIdOrName)
+{
+	_preloads.emplace_back(path, classIdOrName);
+}
+
+bool EasyVstRenderFarm::start(int numThreads, int sampleRate, int maxBlockSize, int symbolicSampleSize)
+{
+	stop();
+
+	if (numThreads < 1) {
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	if (sampleRate <= 0 || maxBlockSize <= 0) {
+		_printError("Invalid sample rate or block size");
+		return false;
+	}
+
+	_sampleRate = sampleRate;
+	_maxBlockSize = maxBlockSize;
+	_symbolicSampleSize = symbolicSampleSize;
+	_completedJobs.store(0);
+	_failedJobs.store(0);
+
+	_running = true;
+	for (int i = 0; i < numThreads; ++i) {
+		_workers.emplace_back(new Worker());
+		_workers.back()->thread = std::thread(&EasyVstRenderFarm::_workerMain, this, _workers.back().get());
+	}
+
+	return true;
+}
+
+void EasyVstRenderFarm::stop()
+{
+	wait();
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_running = false;
+	}
+	_jobAvailable.notify_all();
+
+	for (auto &worker : _workers) {
+		if (worker->thread.joinable()) {
+			worker->thread.join();
+		}
+	}
+	_workers.clear();
+}
+
+void EasyVstRenderFarm::submit(EasyVstRenderJob job)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_jobs.push_back(std::move(job));
+	}
+	_jobAvailable.notify_one();
+}
+
+void EasyVstRenderFarm::wait()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (_workers.empty()) {
+		return;
+	}
+	_idle.wait(lock, [this] { return _jobs.empty() && _activeJobs == 0; });
+}
+
+Steinberg::uint64 EasyVstRenderFarm::completedJobs() const
+{
+	return _completedJobs.load();
+}
+
+Steinberg::uint64 EasyVstRenderFarm::failedJobs() const
+{
+	return _failedJobs.load();
+}
+
+void EasyVstRenderFarm::_workerMain(Worker *worker)
+{
+	for (const auto &preload : _preloads) {
+		_instance(*worker, preload.first, preload.second);
+	}
+
+	while (true) {
+		EasyVstRenderJob job;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_jobAvailable.wait(lock, [this] { return !_jobs.empty() || !_running; });
+			if (_jobs.empty()) {
+				break;
+			}
+			job = std::move(_jobs.front());
+			_jobs.pop_front();
+			++_activeJobs;
+		}
+
+		bool success = _render(*worker, job);
+		(success ? _completedJobs : _failedJobs).fetch_add(1);
+		if (job.done) {
+			job.done(job, success);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			--_activeJobs;
+		}
+		_idle.notify_all();
+	}
+
+	for (auto &entry : worker->instances) {
+		entry.second->vst.destroy();
+	}
+	worker->instances.clear();
+}
+
+EasyVstRenderFarm::Instance *EasyVstRenderFarm::_instance(Worker &worker, const std::string &path, const std::string &classIdOrName)
+{
+	std::string key = path + '\n' + classIdOrName;
+	auto it = worker.instances.find(key);
+	if (it != worker.instances.end()) {
+		return it->second.get();
+	}
+
+	std::unique_ptr<Instance> instance(new Instance());
+	if (!instance->vst.init(path, classIdOrName, _sampleRate, _maxBlockSize, _symbolicSampleSize, false)) {
+		return nullptr;
+	}
+
+	if (instance->vst.numBuses(kAudio, kInput) > 0) {
+		instance->vst.setBusActive(kAudio, kInput, 0, true);
+	}
+	if (instance->vst.numBuses(kAudio, kOutput) > 0) {
+		instance->vst.setBusActive(kAudio, kOutput, 0, true);
+	}
+	if (instance->vst.numBuses(kEvent, kInput) > 0) {
+		instance->vst.setBusActive(kEvent, kInput, 0, true);
+	}
+	instance->hasDefaultState = instance->vst.saveState(instance->defaultState);
+
+	Instance *result = instance.get();
+	worker.instances[key] = std::move(instance);
+	return result;
+}
+
+bool EasyVstRenderFarm::_render(Worker &worker, const EasyVstRenderJob &job)
+{
+	Instance *instance = _instance(worker, job.path, job.classIdOrName);
+	if (!instance) {
+		_printError("Failed to initialize \"" + job.path + "\"");
+		return false;
+	}
+
+	EasyVst &vst = instance->vst;
+	size_t numInputs = _symbolicSampleSize == kSample64 ? job.inputs64.size() : job.inputs32.size();
+	size_t numOutputs = _symbolicSampleSize == kSample64 ? job.outputs64.size() : job.outputs32.size();
+	if ((numInputs != 0 && numInputs != static_cast<size_t>(vst.numChannels(kInput, 0))) || (numOutputs != 0 && numOutputs != static_cast<size_t>(vst.numChannels(kOutput, 0)))) {
+		_printError("Job buffers for \"" + job.path + "\" do not match the channel count of its main buses");
+		return false;
+	}
+
+	if (instance->used) {
+		if (!vst.reset()) {
+			return false;
+		}
+		if (instance->hasDefaultState && !job.state && !vst.loadState(instance->defaultState)) {
+			return false;
+		}
+	}
+	instance->used = true;
+
+	if (job.state) {
+		// Copied into the worker's own streams, since several jobs may share one preset
+		instance->jobState.component.assign(job.state->component.data(), job.state->component.size());
+		instance->jobState.controller.assign(job.state->controller.data(), job.state->controller.size());
+		if (!vst.loadState(instance->jobState)) {
+			return false;
+		}
+	}
+
+	if (job.prepare) {
+		job.prepare(vst);
+	}
+
+	if (_symbolicSampleSize == kSample64) {
+		return vst.renderOffline(job.inputs64.empty() ? nullptr : job.inputs64.data(), job.outputs64.empty() ? nullptr : job.outputs64.data(), job.totalFrames, job.maxTailFrames);
+	}
+	return vst.renderOffline(job.inputs32.empty() ? nullptr : job.inputs32.data(), job.outputs32.empty() ? nullptr : job.outputs32.data(), job.totalFrames, job.maxTailFrames);
+}
+
+void EasyVstRenderFarm::_printError(const std::string &error)
+{
+	std::cerr << "EasyVstRenderFarm error: " << error << std::endl;
+}
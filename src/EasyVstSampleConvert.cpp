@@ -0,0 +1,346 @@
+#include <EasyVstSampleConvert.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define EASYVST_SSE2 1
+#define EASYVST_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define EASYVST_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define EASYVST_NEON 1
+#endif
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+
+namespace {
+// Integer formats use 2^(n-1) in both directions, so integer samples survive a round trip through float
+// unchanged; full-scale positive values clip to 2^(n-1)-1
+const double INT16_SCALE = 32768.0;
+const double INT24_SCALE = 8388608.0;
+const double INT32_SCALE = 2147483648.0;
+
+template <typename SampleType>
+inline int32_t toInteger(SampleType value, double gain, double scale)
+{
+	double scaled = std::rint(static_cast<double>(value) * gain * scale);
+	return static_cast<int32_t>(std::min(scale - 1.0, std::max(-scale, scaled)));
+}
+
+inline int32_t readInt24(const uint8_t *bytes)
+{
+	return static_cast<int32_t>(static_cast<uint32_t>(bytes[0]) << 8 | static_cast<uint32_t>(bytes[1]) << 16 | static_cast<uint32_t>(bytes[2]) << 24) >> 8;
+}
+
+// Channel by channel, so each planar channel is walked sequentially and the format is resolved once per
+// call instead of once per sample
+template <typename SampleType, typename WriteFunction>
+void interleaveChannels(const SampleType *const *planar, int numChannels, uint8_t *out, int frameChannels, int sampleBytes, int startFrame, int numFrames, WriteFunction write)
+{
+	size_t stride = static_cast<size_t>(frameChannels) * sampleBytes;
+	for (int j = 0; j < numChannels; ++j) {
+		const SampleType *source = planar[j];
+		uint8_t *dest = out + startFrame * stride + static_cast<size_t>(j) * sampleBytes;
+		for (int i = startFrame; i < numFrames; ++i, dest += stride) {
+			write(dest, source[i]);
+		}
+	}
+}
+
+template <typename SampleType, typename ReadFunction>
+void deinterleaveChannels(const uint8_t *in, int frameChannels, int sampleBytes, SampleType *const *planar, int numChannels, int startFrame, int numFrames, ReadFunction read)
+{
+	size_t stride = static_cast<size_t>(frameChannels) * sampleBytes;
+	for (int j = 0; j < numChannels; ++j) {
+		SampleType *dest = planar[j];
+		const uint8_t *source = in + startFrame * stride + static_cast<size_t>(j) * sampleBytes;
+		for (int i = startFrame; i < numFrames; ++i, source += stride) {
+			dest[i] = read(source);
+		}
+	}
+}
+
+template <typename SampleType>
+void interleaveScalar(const SampleType *const *planar, int numChannels, void *interleaved, int frameChannels, EasyVstSampleFormat format, int startFrame, int numFrames, double gain)
+{
+	int sampleBytes = EasyVstSampleConvert::bytesPerSample(format);
+	uint8_t *out = static_cast<uint8_t *>(interleaved);
+	switch (format) {
+	case EasyVstSampleFormat::kFloat32:
+		interleaveChannels(planar, numChannels, out, frameChannels, sampleBytes, startFrame, numFrames, [gain](uint8_t *dest, SampleType value) {
+			*reinterpret_cast<float *>(dest) = static_cast<float>(value * gain);
+		});
+		break;
+	case EasyVstSampleFormat::kInt16:
+		interleaveChannels(planar, numChannels, out, frameChannels, sampleBytes, startFrame, numFrames, [gain](uint8_t *dest, SampleType value) {
+			*reinterpret_cast<int16_t *>(dest) = static_cast<int16_t>(toInteger(value, gain, INT16_SCALE));
+		});
+		break;
+	case EasyVstSampleFormat::kInt24:
+		interleaveChannels(planar, numChannels, out, frameChannels, sampleBytes, startFrame, numFrames, [gain](uint8_t *dest, SampleType value) {
+			int32_t sample = toInteger(value, gain, INT24_SCALE);
+			dest[0] = static_cast<uint8_t>(sample);
+			dest[1] = static_cast<uint8_t>(sample >> 8);
+			dest[2] = static_cast<uint8_t>(sample >> 16);
+		});
+		break;
+	case EasyVstSampleFormat::kInt32:
+		interleaveChannels(planar, numChannels, out, frameChannels, sampleBytes, startFrame, numFrames, [gain](uint8_t *dest, SampleType value) {
+			*reinterpret_cast<int32_t *>(dest) = toInteger(value, gain, INT32_SCALE);
+		});
+		break;
+	}
+}
+
+template <typename SampleType>
+void deinterleaveScalar(const void *interleaved, int frameChannels, EasyVstSampleFormat format, SampleType *const *planar, int numChannels, int startFrame, int numFrames, double gain)
+{
+	int sampleBytes = EasyVstSampleConvert::bytesPerSample(format);
+	const uint8_t *in = static_cast<const uint8_t *>(interleaved);
+	switch (format) {
+	case EasyVstSampleFormat::kFloat32:
+		deinterleaveChannels(in, frameChannels, sampleBytes, planar, numChannels, startFrame, numFrames, [gain](const uint8_t *source) {
+			return static_cast<SampleType>(*reinterpret_cast<const float *>(source) * gain);
+		});
+		break;
+	case EasyVstSampleFormat::kInt16:
+		deinterleaveChannels(in, frameChannels, sampleBytes, planar, numChannels, startFrame, numFrames, [gain](const uint8_t *source) {
+			return static_cast<SampleType>(*reinterpret_cast<const int16_t *>(source) / INT16_SCALE * gain);
+		});
+		break;
+	case EasyVstSampleFormat::kInt24:
+		deinterleaveChannels(in, frameChannels, sampleBytes, planar, numChannels, startFrame, numFrames, [gain](const uint8_t *source) {
+			return static_cast<SampleType>(readInt24(source) / INT24_SCALE * gain);
+		});
+		break;
+	case EasyVstSampleFormat::kInt32:
+		deinterleaveChannels(in, frameChannels, sampleBytes, planar, numChannels, startFrame, numFrames, [gain](const uint8_t *source) {
+			return static_cast<SampleType>(*reinterpret_cast<const int32_t *>(source) / INT32_SCALE * gain);
+		});
+		break;
+	}
+}
+
+// Returns the number of frames handled; the caller finishes the remainder with the scalar path
+int interleaveStereoFloat(const float *left, const float *right, float *out, int numFrames, float gain)
+{
+	int i = 0;
+#if defined(EASYVST_AVX2)
+	__m256 g8 = _mm256_set1_ps(gain);
+	for (; i + 8 <= numFrames; i += 8) {
+		__m256 l = _mm256_mul_ps(_mm256_loadu_ps(left + i), g8);
+		__m256 r = _mm256_mul_ps(_mm256_loadu_ps(right + i), g8);
+		__m256 lo = _mm256_unpacklo_ps(l, r);
+		__m256 hi = _mm256_unpackhi_ps(l, r);
+		_mm256_storeu_ps(out + i * 2, _mm256_permute2f128_ps(lo, hi, 0x20));
+		_mm256_storeu_ps(out + i * 2 + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+	}
+#endif
+#if defined(EASYVST_SSE2)
+	__m128 g4 = _mm_set1_ps(gain);
+	for (; i + 4 <= numFrames; i += 4) {
+		__m128 l = _mm_mul_ps(_mm_loadu_ps(left + i), g4);
+		__m128 r = _mm_mul_ps(_mm_loadu_ps(right + i), g4);
+		_mm_storeu_ps(out + i * 2, _mm_unpacklo_ps(l, r));
+		_mm_storeu_ps(out + i * 2 + 4, _mm_unpackhi_ps(l, r));
+	}
+#elif defined(EASYVST_NEON)
+	for (; i + 4 <= numFrames; i += 4) {
+		float32x4x2_t lr;
+		lr.val[0] = vmulq_n_f32(vld1q_f32(left + i), gain);
+		lr.val[1] = vmulq_n_f32(vld1q_f32(right + i), gain);
+		vst2q_f32(out + i * 2, lr);
+	}
+#endif
+	return i;
+}
+
+int deinterleaveStereoFloat(const float *in, float *left, float *right, int numFrames, float gain)
+{
+	int i = 0;
+#if defined(EASYVST_SSE2)
+	__m128 g4 = _mm_set1_ps(gain);
+	for (; i + 4 <= numFrames; i += 4) {
+		__m128 a = _mm_loadu_ps(in + i * 2);
+		__m128 b = _mm_loadu_ps(in + i * 2 + 4);
+		_mm_storeu_ps(left + i, _mm_mul_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), g4));
+		_mm_storeu_ps(right + i, _mm_mul_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)), g4));
+	}
+#elif defined(EASYVST_NEON)
+	for (; i + 4 <= numFrames; i += 4) {
+		float32x4x2_t lr = vld2q_f32(in + i * 2);
+		vst1q_f32(left + i, vmulq_n_f32(lr.val[0], gain));
+		vst1q_f32(right + i, vmulq_n_f32(lr.val[1], gain));
+	}
+#endif
+	return i;
+}
+
+int interleaveStereoInt16(const float *left, const float *right, int16_t *out, int numFrames, float gain)
+{
+	int i = 0;
+#if defined(EASYVST_SSE2)
+	__m128 scale = _mm_set1_ps(static_cast<float>(gain * INT16_SCALE));
+	__m128 lower = _mm_set1_ps(static_cast<float>(-INT16_SCALE));
+	__m128 upper = _mm_set1_ps(static_cast<float>(INT16_SCALE - 1.0));
+	for (; i + 8 <= numFrames; i += 8) {
+		__m128i l0 = _mm_cvtps_epi32(_mm_min_ps(upper, _mm_max_ps(lower, _mm_mul_ps(_mm_loadu_ps(left + i), scale))));
+		__m128i l1 = _mm_cvtps_epi32(_mm_min_ps(upper, _mm_max_ps(lower, _mm_mul_ps(_mm_loadu_ps(left + i + 4), scale))));
+		__m128i r0 = _mm_cvtps_epi32(_mm_min_ps(upper, _mm_max_ps(lower, _mm_mul_ps(_mm_loadu_ps(right + i), scale))));
+		__m128i r1 = _mm_cvtps_epi32(_mm_min_ps(upper, _mm_max_ps(lower, _mm_mul_ps(_mm_loadu_ps(right + i + 4), scale))));
+		__m128i l = _mm_packs_epi32(l0, l1);
+		__m128i r = _mm_packs_epi32(r0, r1);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i * 2), _mm_unpacklo_epi16(l, r));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i * 2 + 8), _mm_unpackhi_epi16(l, r));
+	}
+#elif defined(EASYVST_NEON) && defined(__aarch64__)
+	// vcvtnq_s32_f32 only exists on AArch64; 32-bit ARM takes the scalar loop
+	float32x4_t lower = vdupq_n_f32(static_cast<float>(-INT16_SCALE));
+	float32x4_t upper = vdupq_n_f32(static_cast<float>(INT16_SCALE - 1.0));
+	float scale = static_cast<float>(gain * INT16_SCALE);
+	for (; i + 4 <= numFrames; i += 4) {
+		float32x4_t l = vminq_f32(upper, vmaxq_f32(lower, vmulq_n_f32(vld1q_f32(left + i), scale)));
+		float32x4_t r = vminq_f32(upper, vmaxq_f32(lower, vmulq_n_f32(vld1q_f32(right + i), scale)));
+		int16x4x2_t lr;
+		lr.val[0] = vqmovn_s32(vcvtnq_s32_f32(l));
+		lr.val[1] = vqmovn_s32(vcvtnq_s32_f32(r));
+		vst2_s16(out + i * 2, lr);
+	}
+#endif
+	return i;
+}
+
+int deinterleaveStereoInt16(const int16_t *in, float *left, float *right, int numFrames, float gain)
+{
+	int i = 0;
+#if defined(EASYVST_SSE2)
+	__m128 scale = _mm_set1_ps(static_cast<float>(gain / INT16_SCALE));
+	for (; i + 4 <= numFrames; i += 4) {
+		__m128i frames = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i * 2));
+		__m128i l = _mm_srai_epi32(_mm_slli_epi32(frames, 16), 16);
+		__m128i r = _mm_srai_epi32(frames, 16);
+		_mm_storeu_ps(left + i, _mm_mul_ps(_mm_cvtepi32_ps(l), scale));
+		_mm_storeu_ps(right + i, _mm_mul_ps(_mm_cvtepi32_ps(r), scale));
+	}
+#elif defined(EASYVST_NEON)
+	float scale = static_cast<float>(gain / INT16_SCALE);
+	for (; i + 4 <= numFrames; i += 4) {
+		int16x4x2_t lr = vld2_s16(in + i * 2);
+		vst1q_f32(left + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(lr.val[0])), scale));
+		vst1q_f32(right + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(lr.val[1])), scale));
+	}
+#endif
+	return i;
+}
+}
+
+int EasyVstSampleConvert::bytesPerSample(EasyVstSampleFormat format)
+{
+	switch (format) {
+	case EasyVstSampleFormat::kFloat32:
+		return 4;
+	case EasyVstSampleFormat::kInt16:
+		return 2;
+	case EasyVstSampleFormat::kInt24:
+		return 3;
+	case EasyVstSampleFormat::kInt32:
+		return 4;
+	}
+	return 0;
+}
+
+void EasyVstSampleConvert::interleave(const Sample32 *const *planar, int numChannels, void *interleaved, int frameChannels, EasyVstSampleFormat format, int numFrames, float gain)
+{
+	int done = 0;
+	if (numChannels == 2 && frameChannels == 2) {
+		if (format == EasyVstSampleFormat::kFloat32) {
+			done = interleaveStereoFloat(planar[0], planar[1], static_cast<float *>(interleaved), numFrames, gain);
+		} else if (format == EasyVstSampleFormat::kInt16) {
+			done = interleaveStereoInt16(planar[0], planar[1], static_cast<int16_t *>(interleaved), numFrames, gain);
+		}
+	}
+	interleaveScalar(planar, numChannels, interleaved, frameChannels, format, done, numFrames, gain);
+}
+
+void EasyVstSampleConvert::interleave(const Sample64 *const *planar, int numChannels, void *interleaved, int frameChannels, EasyVstSampleFormat format, int numFrames, float gain)
+{
+	interleaveScalar(planar, numChannels, interleaved, frameChannels, format, 0, numFrames, gain);
+}
+
+void EasyVstSampleConvert::deinterleave(const void *interleaved, int frameChannels, EasyVstSampleFormat format, Sample32 *const *planar, int numChannels, int numFrames, float gain)
+{
+	int done = 0;
+	if (numChannels == 2 && frameChannels == 2) {
+		if (format == EasyVstSampleFormat::kFloat32) {
+			done = deinterleaveStereoFloat(static_cast<const float *>(interleaved), planar[0], planar[1], numFrames, gain);
+		} else if (format == EasyVstSampleFormat::kInt16) {
+			done = deinterleaveStereoInt16(static_cast<const int16_t *>(interleaved), planar[0], planar[1], numFrames, gain);
+		}
+	}
+	deinterleaveScalar(interleaved, frameChannels, format, planar, numChannels, done, numFrames, gain);
+}
+
+void EasyVstSampleConvert::deinterleave(const void *interleaved, int frameChannels, EasyVstSampleFormat format, Sample64 *const *planar, int numChannels, int numFrames, float gain)
+{
+	deinterleaveScalar(interleaved, frameChannels, format, planar, numChannels, 0, numFrames, gain);
+}
+
+void EasyVstSampleConvert::convert(const Sample32 *source, Sample64 *dest, int numSamples, double gain)
+{
+	int i = 0;
+#if defined(EASYVST_AVX2)
+	__m256d g4 = _mm256_set1_pd(gain);
+	for (; i + 4 <= numSamples; i += 4) {
+		_mm256_storeu_pd(dest + i, _mm256_mul_pd(_mm256_cvtps_pd(_mm_loadu_ps(source + i)), g4));
+	}
+#elif defined(EASYVST_SSE2)
+	__m128d g2 = _mm_set1_pd(gain);
+	for (; i + 4 <= numSamples; i += 4) {
+		__m128 v = _mm_loadu_ps(source + i);
+		_mm_storeu_pd(dest + i, _mm_mul_pd(_mm_cvtps_pd(v), g2));
+		_mm_storeu_pd(dest + i + 2, _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(v, v)), g2));
+	}
+#elif defined(EASYVST_NEON) && defined(__aarch64__)
+	for (; i + 4 <= numSamples; i += 4) {
+		float32x4_t v = vld1q_f32(source + i);
+		vst1q_f64(dest + i, vmulq_n_f64(vcvt_f64_f32(vget_low_f32(v)), gain));
+		vst1q_f64(dest + i + 2, vmulq_n_f64(vcvt_high_f64_f32(v), gain));
+	}
+#endif
+	for (; i < numSamples; ++i) {
+		dest[i] = source[i] * gain;
+	}
+}
+
+void EasyVstSampleConvert::convert(const Sample64 *source, Sample32 *dest, int numSamples, double gain)
+{
+	int i = 0;
+#if defined(EASYVST_AVX2)
+	__m256d g4 = _mm256_set1_pd(gain);
+	for (; i + 4 <= numSamples; i += 4) {
+		_mm_storeu_ps(dest + i, _mm256_cvtpd_ps(_mm256_mul_pd(_mm256_loadu_pd(source + i), g4)));
+	}
+#elif defined(EASYVST_SSE2)
+	__m128d g2 = _mm_set1_pd(gain);
+	for (; i + 4 <= numSamples; i += 4) {
+		__m128 lo = _mm_cvtpd_ps(_mm_mul_pd(_mm_loadu_pd(source + i), g2));
+		__m128 hi = _mm_cvtpd_ps(_mm_mul_pd(_mm_loadu_pd(source + i + 2), g2));
+		_mm_storeu_ps(dest + i, _mm_movelh_ps(lo, hi));
+	}
+#elif defined(EASYVST_NEON) && defined(__aarch64__)
+	for (; i + 4 <= numSamples; i += 4) {
+		float32x2_t lo = vcvt_f32_f64(vmulq_n_f64(vld1q_f64(source + i), gain));
+		vst1q_f32(dest + i, vcvt_high_f32_f64(lo, vmulq_n_f64(vld1q_f64(source + i + 2), gain)));
+	}
+#endif
+	for (; i < numSamples; ++i) {
+		dest[i] = static_cast<Sample32>(source[i] * gain);
+	}
+}
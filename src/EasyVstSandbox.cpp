@@ -0,0 +1,711 @@
+#include <EasyVstSandbox.h>
+#include <EasyVst.h>
+
+#include <cstdio>
+#include <new>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <limits.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cerrno>
+#include <ctime>
+#endif
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+
+static const int MAX_SANDBOX_BUSES = 16;
+static const int MAX_SANDBOX_PATH = 4096;
+static const int SPIN_ITERATIONS = 4000;
+static const int INIT_TIMEOUT_MS = 30000;
+static const int PROCESS_TIMEOUT_MS = 2000;
+static const int COMMAND_TIMEOUT_MS = 5000;
+static const int CRASH_POLL_MS = 1;
+static const int HELPER_REGION_FD = 3;
+static const size_t CHANNEL_ALIGNMENT = 64;
+
+enum SandboxCommand : uint32 {
+	kSandboxNone = 0,
+	kSandboxProcess,
+	kSandboxSetProcessing,
+	kSandboxSetBusActive,
+	kSandboxQuit
+};
+
+struct SandboxParamPoint {
+	ParamID id;
+	int32 sampleOffset;
+	ParamValue value;
+};
+
+struct EasyVstSandboxControl {
+	std::atomic<uint32> requestSeq;
+	std::atomic<uint32> responseSeq;
+	uint32 command;
+	int32 args[4];
+	int32 result;
+
+	// Written by the parent before forking
+	int32 sampleRate, maxBlockSize, symbolicSampleSize, realtime;
+	int32 eventCapacity, parameterCapacity;
+	char path[MAX_SANDBOX_PATH];
+
+	// Written by the child once the plugin is initialized
+	int32 initResult;
+	char name[256];
+	int32 numBuses[kNumMediaTypes][2];
+	BusInfo busInfos[kNumMediaTypes][2][MAX_SANDBOX_BUSES];
+	uint64 totalSize;
+	uint64 inEventsOffset, outEventsOffset, inParamsOffset, outParamsOffset, audioOffset;
+
+	// Per-block data
+	int32 numSamples;
+	ProcessContext processContext;
+	int32 numInEvents, numOutEvents, numInParams, numOutParams;
+	uint64 silenceFlags[2][MAX_SANDBOX_BUSES];
+};
+
+std::string EasyVstSandbox::_helperPath;
+
+void EasyVstSandbox::setHelperPath(const std::string &path)
+{
+	_helperPath = path;
+}
+
+#ifdef __linux__
+
+extern char **environ;
+
+static size_t alignUp(size_t value, size_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+static size_t channelStride(const EasyVstSandboxControl *control)
+{
+	size_t sampleBytes = control->symbolicSampleSize == kSample64 ? sizeof(Sample64) : sizeof(Sample32);
+	return alignUp(control->maxBlockSize * sampleBytes, CHANNEL_ALIGNMENT);
+}
+
+static void computeLayout(EasyVstSandboxControl *control)
+{
+	size_t offset = alignUp(sizeof(EasyVstSandboxControl), CHANNEL_ALIGNMENT);
+	control->inEventsOffset = offset;
+	offset = alignUp(offset + control->eventCapacity * sizeof(Event), CHANNEL_ALIGNMENT);
+	control->outEventsOffset = offset;
+	offset = alignUp(offset + control->eventCapacity * sizeof(Event), CHANNEL_ALIGNMENT);
+	control->inParamsOffset = offset;
+	offset = alignUp(offset + control->parameterCapacity * sizeof(SandboxParamPoint), CHANNEL_ALIGNMENT);
+	control->outParamsOffset = offset;
+	offset = alignUp(offset + control->parameterCapacity * sizeof(SandboxParamPoint), CHANNEL_ALIGNMENT);
+	control->audioOffset = offset;
+
+	for (int direction = kInput; direction <= kOutput; ++direction) {
+		for (int i = 0; i < control->numBuses[kAudio][direction]; ++i) {
+			offset += control->busInfos[kAudio][direction][i].channelCount * channelStride(control);
+		}
+	}
+	control->totalSize = alignUp(offset, static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+}
+
+static void *channelAddress(void *region, const EasyVstSandboxControl *control, int direction, int bus, int channel)
+{
+	size_t offset = control->audioOffset;
+	for (int d = kInput; d <= direction; ++d) {
+		int numBuses = d == direction ? bus : control->numBuses[kAudio][d];
+		for (int i = 0; i < numBuses; ++i) {
+			offset += control->busInfos[kAudio][d][i].channelCount * channelStride(control);
+		}
+	}
+	offset += channel * channelStride(control);
+	return static_cast<char *>(region) + offset;
+}
+
+template <typename T>
+static T *regionArray(void *region, uint64 offset)
+{
+	return reinterpret_cast<T *>(static_cast<char *>(region) + offset);
+}
+
+static void futexWake(std::atomic<uint32> *word)
+{
+	syscall(SYS_futex, reinterpret_cast<uint32 *>(word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+static void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	asm volatile("yield");
+#endif
+}
+
+// Waits until *word != value; returns false on timeout. A negative timeout waits forever.
+static bool futexWaitChange(std::atomic<uint32> *word, uint32 value, int timeoutMs)
+{
+	for (int i = 0; i < SPIN_ITERATIONS; ++i) {
+		if (word->load(std::memory_order_acquire) != value) {
+			return true;
+		}
+		cpuRelax();
+	}
+
+	timespec deadline = {};
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+	deadline.tv_sec += timeoutMs / 1000;
+	deadline.tv_nsec += (timeoutMs % 1000) * 1000000L;
+	if (deadline.tv_nsec >= 1000000000L) {
+		++deadline.tv_sec;
+		deadline.tv_nsec -= 1000000000L;
+	}
+
+	while (word->load(std::memory_order_acquire) == value) {
+		timespec remaining = {};
+		timespec *timeout = nullptr;
+		if (timeoutMs >= 0) {
+			timespec now = {};
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			int64 remainingNs = (deadline.tv_sec - now.tv_sec) * 1000000000LL + (deadline.tv_nsec - now.tv_nsec);
+			if (remainingNs <= 0) {
+				return false;
+			}
+			remaining.tv_sec = remainingNs / 1000000000LL;
+			remaining.tv_nsec = remainingNs % 1000000000LL;
+			timeout = &remaining;
+		}
+		syscall(SYS_futex, reinterpret_cast<uint32 *>(word), FUTEX_WAIT, value, timeout, nullptr, 0);
+	}
+	return true;
+}
+
+static void respond(EasyVstSandboxControl *control)
+{
+	control->responseSeq.fetch_add(1, std::memory_order_release);
+	futexWake(&control->responseSeq);
+}
+
+int EasyVstSandbox::runChild(int fd, size_t initialSize, int parentPid)
+{
+	// The host may have exited before the death signal was armed
+	prctl(PR_SET_PDEATHSIG, SIGKILL);
+	if (getppid() != parentPid) {
+		return 1;
+	}
+
+	void *region = mmap(nullptr, initialSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (region == MAP_FAILED) {
+		return 1;
+	}
+	EasyVstSandboxControl *control = static_cast<EasyVstSandboxControl *>(region);
+
+	EasyVst vst;
+	vst.setEventCapacity(control->eventCapacity);
+	vst.setParameterQueueCapacity(control->parameterCapacity);
+	bool success = vst.init(control->path, control->sampleRate, control->maxBlockSize, control->symbolicSampleSize, control->realtime != 0);
+
+	for (int type = kAudio; success && type <= kEvent; ++type) {
+		for (int direction = kInput; direction <= kOutput; ++direction) {
+			int numBuses = vst.numBuses(type, direction);
+			if (numBuses > MAX_SANDBOX_BUSES) {
+				success = false;
+				break;
+			}
+			control->numBuses[type][direction] = numBuses;
+			for (int i = 0; i < numBuses; ++i) {
+				control->busInfos[type][direction][i] = *vst.busInfo(type, direction, i);
+			}
+		}
+	}
+
+	if (success) {
+		std::snprintf(control->name, sizeof(control->name), "%s", vst.name().c_str());
+		computeLayout(control);
+		success = ftruncate(fd, control->totalSize) == 0;
+	}
+	if (success) {
+		void *fullRegion = mmap(nullptr, control->totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		success = fullRegion != MAP_FAILED;
+		if (success) {
+			munmap(region, initialSize);
+			region = fullRegion;
+			control = static_cast<EasyVstSandboxControl *>(region);
+		}
+	}
+
+	if (!success) {
+		control->initResult = -1;
+		respond(control);
+		return 1;
+	}
+
+	for (int direction = kInput; direction <= kOutput; ++direction) {
+		for (int i = 0; i < control->numBuses[kAudio][direction]; ++i) {
+			std::vector<void *> channels(control->busInfos[kAudio][direction][i].channelCount);
+			for (size_t j = 0; j < channels.size(); ++j) {
+				channels[j] = channelAddress(region, control, direction, i, static_cast<int>(j));
+			}
+			vst._bindAudioBus(direction, i, channels.data());
+		}
+	}
+
+	control->initResult = 1;
+	uint32 lastRequest = control->requestSeq.load(std::memory_order_acquire);
+	respond(control);
+
+	while (true) {
+		futexWaitChange(&control->requestSeq, lastRequest, -1);
+		lastRequest = control->requestSeq.load(std::memory_order_acquire);
+
+		switch (control->command) {
+		case kSandboxProcess: {
+			EventList *inEvents = control->numBuses[kEvent][kInput] > 0 ? vst.eventList(kInput, 0) : nullptr;
+			Event *sharedInEvents = regionArray<Event>(region, control->inEventsOffset);
+			for (int i = 0; inEvents && i < control->numInEvents; ++i) {
+				inEvents->addEvent(sharedInEvents[i]);
+			}
+
+			SandboxParamPoint *sharedInParams = regionArray<SandboxParamPoint>(region, control->inParamsOffset);
+			for (int i = 0; i < control->numInParams; ++i) {
+				vst.queueParameterChange(sharedInParams[i].id, sharedInParams[i].value, vst.samplePosition() + sharedInParams[i].sampleOffset);
+			}
+
+			*vst.processContext() = control->processContext;
+			for (int i = 0; i < control->numBuses[kAudio][kInput]; ++i) {
+				vst._hostBuses(kInput)[i].silenceFlags = control->silenceFlags[kInput][i];
+			}
+
+			control->result = vst.process(control->numSamples) ? kResultOk : kResultFalse;
+
+			for (int i = 0; i < control->numBuses[kAudio][kOutput]; ++i) {
+				control->silenceFlags[kOutput][i] = vst._hostBuses(kOutput)[i].silenceFlags;
+			}
+
+			control->numOutEvents = 0;
+			if (control->numBuses[kEvent][kOutput] > 0) {
+				EventList *outEvents = vst.eventList(kOutput, 0);
+				Event *sharedOutEvents = regionArray<Event>(region, control->outEventsOffset);
+				int numEvents = std::min(static_cast<int>(outEvents->getEventCount()), control->eventCapacity);
+				for (int i = 0; i < numEvents; ++i) {
+					sharedOutEvents[i] = *outEvents->getEventByIndex(i);
+				}
+				control->numOutEvents = numEvents;
+			}
+
+			control->numOutParams = 0;
+			ParameterChanges *outParams = vst.parameterChanges(kOutput, 0);
+			SandboxParamPoint *sharedOutParams = regionArray<SandboxParamPoint>(region, control->outParamsOffset);
+			for (int32 i = 0; i < outParams->getParameterCount(); ++i) {
+				IParamValueQueue *queue = outParams->getParameterData(i);
+				for (int32 j = 0; queue && j < queue->getPointCount() && control->numOutParams < control->parameterCapacity; ++j) {
+					SandboxParamPoint &point = sharedOutParams[control->numOutParams++];
+					point.id = queue->getParameterId();
+					queue->getPoint(j, point.sampleOffset, point.value);
+				}
+			}
+			break;
+		}
+		case kSandboxSetProcessing:
+			vst.setProcessing(control->args[0] != 0);
+			control->result = kResultOk;
+			break;
+		case kSandboxSetBusActive:
+			vst.setBusActive(control->args[0], control->args[1], control->args[2], control->args[3] != 0);
+			control->result = kResultOk;
+			break;
+		case kSandboxQuit:
+			vst.destroy();
+			control->result = kResultOk;
+			respond(control);
+			return 0;
+		default:
+			control->result = kResultFalse;
+			break;
+		}
+
+		respond(control);
+	}
+}
+
+EasyVstSandbox::EasyVstSandbox()
+{}
+
+EasyVstSandbox::~EasyVstSandbox()
+{
+	stop();
+}
+
+bool EasyVstSandbox::start(EasyVst &host)
+{
+	stop();
+	_crashed = false;
+
+	if (host._path.size() >= MAX_SANDBOX_PATH) {
+		host._printError("Plugin path is too long for sandboxed hosting");
+		return false;
+	}
+
+	std::string helperPath = _helperPath.empty() ? _defaultHelperPath() : _helperPath;
+	if (helperPath.empty()) {
+		host._printError("Failed to locate the sandbox helper executable");
+		return false;
+	}
+
+	// Close-on-exec so that other processes the host starts never inherit it; only the helper gets a copy
+	_fd = static_cast<int>(syscall(SYS_memfd_create, "easyvst-sandbox", MFD_CLOEXEC));
+	if (_fd < 0) {
+		host._printError("Failed to create sandbox shared memory");
+		return false;
+	}
+
+	size_t initialSize = alignUp(sizeof(EasyVstSandboxControl), static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+	if (ftruncate(_fd, initialSize) != 0 || !_mapRegion(initialSize)) {
+		host._printError("Failed to map sandbox shared memory");
+		stop();
+		return false;
+	}
+
+	new (_control) EasyVstSandboxControl();
+	_control->sampleRate = host._sampleRate;
+	_control->maxBlockSize = host._maxBlockSize;
+	_control->symbolicSampleSize = host._symbolicSampleSize;
+	_control->realtime = host._realtime ? 1 : 0;
+	_control->eventCapacity = host._eventCapacity;
+	_control->parameterCapacity = host._parameterQueueCapacity;
+	std::snprintf(_control->path, sizeof(_control->path), "%s", host._path.c_str());
+
+	uint32 lastResponse = _control->responseSeq.load(std::memory_order_acquire);
+
+	// dup2() onto the same number would keep close-on-exec set, so such a descriptor is moved out of the way first
+	int spawnFd = _fd == HELPER_REGION_FD ? fcntl(_fd, F_DUPFD_CLOEXEC, HELPER_REGION_FD + 1) : _fd;
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	bool prepared = spawnFd >= 0 && posix_spawn_file_actions_adddup2(&actions, spawnFd, HELPER_REGION_FD) == 0;
+
+	std::string fdArg = std::to_string(HELPER_REGION_FD), sizeArg = std::to_string(initialSize), parentArg = std::to_string(getpid());
+	char *argv[] = {const_cast<char *>(helperPath.c_str()), const_cast<char *>(fdArg.c_str()), const_cast<char *>(sizeArg.c_str()), const_cast<char *>(parentArg.c_str()), nullptr};
+	pid_t pid = -1;
+	bool spawned = prepared && posix_spawn(&pid, helperPath.c_str(), &actions, nullptr, argv, environ) == 0;
+	posix_spawn_file_actions_destroy(&actions);
+	if (spawnFd >= 0 && spawnFd != _fd) {
+		close(spawnFd);
+	}
+	if (!spawned) {
+		host._printError("Failed to start sandbox helper \"" + helperPath + "\"");
+		stop();
+		return false;
+	}
+	_pid = pid;
+
+	if (!_awaitResponse(lastResponse, INIT_TIMEOUT_MS) || _control->initResult != 1) {
+		host._printError("Sandboxed plugin failed to initialize");
+		_kill();
+		stop();
+		return false;
+	}
+
+	size_t totalSize = _control->totalSize;
+	munmap(_region, _regionSize);
+	_region = nullptr;
+	_control = nullptr;
+	if (!_mapRegion(totalSize)) {
+		host._printError("Failed to map sandbox audio buffers");
+		_kill();
+		stop();
+		return false;
+	}
+
+	host._name = _control->name;
+	for (int type = kAudio; type <= kEvent; ++type) {
+		for (int direction = kInput; direction <= kOutput; ++direction) {
+			std::vector<BusInfo> &infos = type == kAudio ? (direction == kInput ? host._inAudioBusInfos : host._outAudioBusInfos) : (direction == kInput ? host._inEventBusInfos : host._outEventBusInfos);
+			int &numBuses = type == kAudio ? (direction == kInput ? host._numInAudioBuses : host._numOutAudioBuses) : (direction == kInput ? host._numInEventBuses : host._numOutEventBuses);
+			numBuses = _control->numBuses[type][direction];
+			infos.assign(_control->busInfos[type][direction], _control->busInfos[type][direction] + numBuses);
+		}
+	}
+
+	for (int direction = kInput; direction <= kOutput; ++direction) {
+		int numBuses = _control->numBuses[kAudio][direction];
+		_busBuffers[direction].assign(numBuses, AudioBusBuffers());
+		_channels32[direction].assign(numBuses, {});
+		_channels64[direction].assign(numBuses, {});
+		for (int i = 0; i < numBuses; ++i) {
+			int numChannels = _control->busInfos[kAudio][direction][i].channelCount;
+			AudioBusBuffers &bus = _busBuffers[direction][i];
+			bus.numChannels = numChannels;
+			bus.silenceFlags = 0;
+			for (int j = 0; j < numChannels; ++j) {
+				void *address = channelAddress(_region, _control, direction, i, j);
+				_channels32[direction][i].push_back(static_cast<Sample32 *>(address));
+				_channels64[direction][i].push_back(static_cast<Sample64 *>(address));
+			}
+			if (host._symbolicSampleSize == kSample64) {
+				bus.channelBuffers64 = _channels64[direction][i].data();
+			} else {
+				bus.channelBuffers32 = _channels32[direction][i].data();
+			}
+		}
+	}
+
+	host._processData.numInputs = static_cast<int32>(_busBuffers[kInput].size());
+	host._processData.numOutputs = static_cast<int32>(_busBuffers[kOutput].size());
+	host._processData.inputs = _busBuffers[kInput].data();
+	host._processData.outputs = _busBuffers[kOutput].data();
+
+	return true;
+}
+
+void EasyVstSandbox::stop()
+{
+	if (_pid > 0) {
+		if (!_crashed && _control && !_request(kSandboxQuit, COMMAND_TIMEOUT_MS)) {
+			_kill();
+		}
+		waitpid(_pid, nullptr, 0);
+		_pid = -1;
+	}
+
+	if (_region) {
+		munmap(_region, _regionSize);
+		_region = nullptr;
+		_regionSize = 0;
+		_control = nullptr;
+	}
+	if (_fd >= 0) {
+		close(_fd);
+		_fd = -1;
+	}
+
+	for (int direction = kInput; direction <= kOutput; ++direction) {
+		_busBuffers[direction].clear();
+		_channels32[direction].clear();
+		_channels64[direction].clear();
+	}
+}
+
+Steinberg::tresult EasyVstSandbox::process(EasyVst &host)
+{
+	if (_crashed) {
+		return kInternalError;
+	}
+
+	_control->numSamples = host._processData.numSamples;
+	_control->processContext = host._processContext;
+	for (int i = 0; i < host._processData.numInputs; ++i) {
+		_control->silenceFlags[kInput][i] = host._processData.inputs[i].silenceFlags;
+	}
+
+	// Data events carry pointers into this process and cannot be forwarded
+	_control->numInEvents = 0;
+	if (IEventList *inEvents = host._processData.inputEvents) {
+		Event *sharedInEvents = regionArray<Event>(_region, _control->inEventsOffset);
+		int numEvents = inEvents->getEventCount();
+		for (int i = 0; i < numEvents && _control->numInEvents < _control->eventCapacity; ++i) {
+			Event event = {};
+			if (inEvents->getEvent(i, event) == kResultOk && event.type != Event::kDataEvent) {
+				sharedInEvents[_control->numInEvents++] = event;
+			}
+		}
+	}
+
+	_control->numInParams = 0;
+	SandboxParamPoint *sharedInParams = regionArray<SandboxParamPoint>(_region, _control->inParamsOffset);
+	for (int32 i = 0; i < host._inParameterChanges.getParameterCount(); ++i) {
+		IParamValueQueue *queue = host._inParameterChanges.getParameterData(i);
+		for (int32 j = 0; queue && j < queue->getPointCount() && _control->numInParams < _control->parameterCapacity; ++j) {
+			SandboxParamPoint &point = sharedInParams[_control->numInParams++];
+			point.id = queue->getParameterId();
+			queue->getPoint(j, point.sampleOffset, point.value);
+		}
+	}
+
+	if (!_request(kSandboxProcess, PROCESS_TIMEOUT_MS)) {
+		return kInternalError;
+	}
+
+	for (int i = 0; i < host._processData.numOutputs; ++i) {
+		host._processData.outputs[i].silenceFlags = _control->silenceFlags[kOutput][i];
+	}
+
+	if (host._outEventLists) {
+		Event *sharedOutEvents = regionArray<Event>(_region, _control->outEventsOffset);
+		for (int i = 0; i < _control->numOutEvents; ++i) {
+			host._outEventLists->addEvent(sharedOutEvents[i]);
+		}
+	}
+
+	SandboxParamPoint *sharedOutParams = regionArray<SandboxParamPoint>(_region, _control->outParamsOffset);
+	for (int i = 0; i < _control->numOutParams; ++i) {
+		int32 queueIndex = 0, pointIndex = 0;
+		IParamValueQueue *queue = host._outParameterChanges.addParameterData(sharedOutParams[i].id, queueIndex);
+		if (queue) {
+			queue->addPoint(sharedOutParams[i].sampleOffset, sharedOutParams[i].value, pointIndex);
+		}
+	}
+
+	return _control->result;
+}
+
+bool EasyVstSandbox::setProcessing(bool processing)
+{
+	if (_crashed) {
+		return false;
+	}
+
+	_control->args[0] = processing ? 1 : 0;
+	return _request(kSandboxSetProcessing, COMMAND_TIMEOUT_MS);
+}
+
+bool EasyVstSandbox::setBusActive(MediaType type, BusDirection direction, int which, bool active)
+{
+	if (_crashed) {
+		return false;
+	}
+
+	_control->args[0] = type;
+	_control->args[1] = direction;
+	_control->args[2] = which;
+	_control->args[3] = active ? 1 : 0;
+	return _request(kSandboxSetBusActive, COMMAND_TIMEOUT_MS);
+}
+
+bool EasyVstSandbox::crashed() const
+{
+	return _crashed;
+}
+
+bool EasyVstSandbox::_request(uint32 command, int timeoutMs)
+{
+	uint32 lastResponse = _control->responseSeq.load(std::memory_order_acquire);
+	_control->command = command;
+	_control->requestSeq.fetch_add(1, std::memory_order_release);
+	futexWake(&_control->requestSeq);
+
+	if (_awaitResponse(lastResponse, timeoutMs)) {
+		return true;
+	}
+
+	if (_crashed) {
+		std::cerr << "Sandboxed VST3 plugin process exited" << std::endl;
+	} else {
+		// The child is stuck inside the plugin and cannot be trusted any more
+		std::cerr << "Sandboxed VST3 plugin stopped responding" << std::endl;
+		_kill();
+	}
+	return false;
+}
+
+// Waits in short slices and checks on the child in between, so that a crash is noticed within about a
+// millisecond instead of after the whole timeout
+bool EasyVstSandbox::_awaitResponse(uint32 lastResponse, int timeoutMs)
+{
+	int waitedMs = 0;
+	while (!futexWaitChange(&_control->responseSeq, lastResponse, CRASH_POLL_MS)) {
+		if (_reapChild()) {
+			return false;
+		}
+		waitedMs += CRASH_POLL_MS;
+		if (timeoutMs >= 0 && waitedMs >= timeoutMs) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool EasyVstSandbox::_reapChild()
+{
+	if (_pid <= 0 || waitpid(_pid, nullptr, WNOHANG) != _pid) {
+		return false;
+	}
+
+	_pid = -1;
+	_crashed = true;
+	return true;
+}
+
+std::string EasyVstSandbox::_defaultHelperPath()
+{
+	char executable[PATH_MAX] = {};
+	ssize_t length = readlink("/proc/self/exe", executable, sizeof(executable) - 1);
+	if (length <= 0) {
+		return {};
+	}
+
+	std::string path(executable, static_cast<size_t>(length));
+	size_t slash = path.rfind('/');
+	return path.substr(0, slash + 1) + "easyvst-sandbox-host";
+}
+
+bool EasyVstSandbox::_mapRegion(size_t size)
+{
+	void *region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+	if (region == MAP_FAILED) {
+		return false;
+	}
+
+	_region = region;
+	_regionSize = size;
+	_control = static_cast<EasyVstSandboxControl *>(region);
+	return true;
+}
+
+void EasyVstSandbox::_kill()
+{
+	if (_pid > 0) {
+		kill(_pid, SIGKILL);
+	}
+	_crashed = true;
+}
+
+#else
+
+EasyVstSandbox::EasyVstSandbox()
+{}
+
+EasyVstSandbox::~EasyVstSandbox()
+{}
+
+bool EasyVstSandbox::start(EasyVst &host)
+{
+	host._printError("Sandboxed hosting is only supported on Linux");
+	return false;
+}
+
+void EasyVstSandbox::stop()
+{}
+
+Steinberg::tresult EasyVstSandbox::process(EasyVst & /*host*/)
+{
+	return kNotImplemented;
+}
+
+bool EasyVstSandbox::setProcessing(bool /*processing*/)
+{
+	return false;
+}
+
+bool EasyVstSandbox::setBusActive(MediaType /*type*/, BusDirection /*direction*/, int /*which*/, bool /*active*/)
+{
+	return false;
+}
+
+bool EasyVstSandbox::crashed() const
+{
+	return false;
+}
+
+int EasyVstSandbox::runChild(int /*fd*/, size_t /*initialSize*/, int /*parentPid*/)
+{
+	return 1;
+}
+
+#endif
@@ -0,0 +1,361 @@
+#include <EasyVstScanner.h>
+
+#include <public.sdk/source/vst/utility/stringconvert.h>
+
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+
+static const uint32 CACHE_MAGIC = 0x43535645; // "EVSC"
+static const uint32 CACHE_VERSION = 2;
+static const uint32 MAX_CACHE_STRING = 1 << 16;
+static const uint32 MAX_CACHE_COUNT = 1 << 20;
+
+static const uint64 FNV_OFFSET = 14695981039346656037ull;
+static const uint64 FNV_PRIME = 1099511628211ull;
+
+static uint64 fnv1a(uint64 hash, const void *data, size_t size)
+{
+	const unsigned char *bytes = static_cast<const unsigned char *>(data);
+	for (size_t i = 0; i < size; ++i) {
+		hash = (hash ^ bytes[i]) * FNV_PRIME;
+	}
+	return hash;
+}
+
+// Hashes the name, size and modification time of every file in the bundle, so that any change to the
+// bundle's contents invalidates its cache entry without reading the binaries themselves
+static bool fingerprintBundle(const std::string &path, int64 &modifiedTime, uint64 &fingerprint)
+{
+	namespace fs = std::filesystem;
+
+	std::error_code ec;
+	fs::path root(path);
+	if (!fs::exists(root, ec)) {
+		return false;
+	}
+
+	modifiedTime = 0;
+	fingerprint = FNV_OFFSET;
+
+	auto addFile = [&](const fs::path &file) {
+		int64 fileTime = fs::last_write_time(file, ec).time_since_epoch().count();
+		uint64 fileSize = fs::is_regular_file(file, ec) ? fs::file_size(file, ec) : 0;
+		std::string relative = file.lexically_relative(root).generic_string();
+		fingerprint = fnv1a(fingerprint, relative.data(), relative.size());
+		fingerprint = fnv1a(fingerprint, &fileSize, sizeof(fileSize));
+		fingerprint = fnv1a(fingerprint, &fileTime, sizeof(fileTime));
+		modifiedTime = std::max(modifiedTime, fileTime);
+	};
+
+	addFile(root);
+	if (fs::is_directory(root, ec)) {
+		std::vector<fs::path> files;
+		for (fs::recursive_directory_iterator it(root, ec), end; it != end; it.increment(ec)) {
+			files.push_back(it->path());
+		}
+		std::sort(files.begin(), files.end());
+		for (const fs::path &file : files) {
+			addFile(file);
+		}
+	}
+
+	return true;
+}
+
+template <typename T>
+static void writePod(std::ostream &out, const T &value)
+{
+	out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+static bool readPod(std::istream &in, T &value)
+{
+	in.read(reinterpret_cast<char *>(&value), sizeof(T));
+	return static_cast<bool>(in);
+}
+
+static void writeString(std::ostream &out, const std::string &value)
+{
+	writePod(out, static_cast<uint32>(value.size()));
+	out.write(value.data(), value.size());
+}
+
+static bool readString(std::istream &in, std::string &value)
+{
+	uint32 size = 0;
+	if (!readPod(in, size) || size > MAX_CACHE_STRING) {
+		return false;
+	}
+	value.resize(size);
+	in.read(&value[0], size);
+	return static_cast<bool>(in);
+}
+
+EasyVstScanner::EasyVstScanner()
+{}
+
+EasyVstScanner::~EasyVstScanner()
+{}
+
+bool EasyVstScanner::loadCache(const std::string &cachePath)
+{
+	std::ifstream in(cachePath, std::ios::binary);
+	if (!in) {
+		return false;
+	}
+
+	uint32 magic = 0, version = 0, numPlugins = 0;
+	if (!readPod(in, magic) || !readPod(in, version) || !readPod(in, numPlugins) || magic != CACHE_MAGIC || version != CACHE_VERSION || numPlugins > MAX_CACHE_COUNT) {
+		_printError(cachePath, "Invalid or outdated plugin cache");
+		return false;
+	}
+
+	std::vector<EasyVstPluginRecord> plugins(numPlugins);
+	for (EasyVstPluginRecord &plugin : plugins) {
+		uint8 loadFailed = 0;
+		uint32 numClasses = 0;
+		if (!readString(in, plugin.path) || !readPod(in, plugin.modifiedTime) || !readPod(in, plugin.fingerprint) || !readPod(in, loadFailed) || !readString(in, plugin.error) || !readPod(in, numClasses) || numClasses > MAX_CACHE_COUNT) {
+			_printError(cachePath, "Corrupt plugin cache");
+			return false;
+		}
+		plugin.loadFailed = loadFailed != 0;
+
+		plugin.classes.resize(numClasses);
+		for (EasyVstClassRecord &classRecord : plugin.classes) {
+			uint8 probed = 0, supports64Bit = 0;
+			uint32 numBuses = 0;
+			bool ok = readString(in, classRecord.uid) && readString(in, classRecord.name) && readString(in, classRecord.category) && readString(in, classRecord.subCategories) && readString(in, classRecord.vendor) && readString(in, classRecord.version) && readString(in, classRecord.sdkVersion);
+			ok = ok && readPod(in, probed) && readPod(in, supports64Bit) && readPod(in, classRecord.latencySamples) && readPod(in, classRecord.tailSamples) && readPod(in, classRecord.processContextRequirements);
+			ok = ok && readPod(in, numBuses) && numBuses <= MAX_CACHE_COUNT;
+			if (!ok) {
+				_printError(cachePath, "Corrupt plugin cache");
+				return false;
+			}
+			classRecord.probed = probed != 0;
+			classRecord.supports64Bit = supports64Bit != 0;
+
+			classRecord.buses.resize(numBuses);
+			for (EasyVstBusLayout &bus : classRecord.buses) {
+				if (!readString(in, bus.name) || !readPod(in, bus.mediaType) || !readPod(in, bus.direction) || !readPod(in, bus.channelCount) || !readPod(in, bus.busType) || !readPod(in, bus.flags) || !readPod(in, bus.speakerArrangement)) {
+					_printError(cachePath, "Corrupt plugin cache");
+					return false;
+				}
+			}
+		}
+	}
+
+	_plugins = std::move(plugins);
+	return true;
+}
+
+bool EasyVstScanner::saveCache(const std::string &cachePath) const
+{
+	std::string tempPath = cachePath + ".tmp";
+	{
+		std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+		if (!out) {
+			std::cerr << "Error writing plugin cache \"" << cachePath << "\"" << std::endl;
+			return false;
+		}
+
+		writePod(out, CACHE_MAGIC);
+		writePod(out, CACHE_VERSION);
+		writePod(out, static_cast<uint32>(_plugins.size()));
+		for (const EasyVstPluginRecord &plugin : _plugins) {
+			writeString(out, plugin.path);
+			writePod(out, plugin.modifiedTime);
+			writePod(out, plugin.fingerprint);
+			writePod(out, static_cast<uint8>(plugin.loadFailed));
+			writeString(out, plugin.error);
+			writePod(out, static_cast<uint32>(plugin.classes.size()));
+			for (const EasyVstClassRecord &classRecord : plugin.classes) {
+				writeString(out, classRecord.uid);
+				writeString(out, classRecord.name);
+				writeString(out, classRecord.category);
+				writeString(out, classRecord.subCategories);
+				writeString(out, classRecord.vendor);
+				writeString(out, classRecord.version);
+				writeString(out, classRecord.sdkVersion);
+				writePod(out, static_cast<uint8>(classRecord.probed));
+				writePod(out, static_cast<uint8>(classRecord.supports64Bit));
+				writePod(out, classRecord.latencySamples);
+				writePod(out, classRecord.tailSamples);
+				writePod(out, classRecord.processContextRequirements);
+				writePod(out, static_cast<uint32>(classRecord.buses.size()));
+				for (const EasyVstBusLayout &bus : classRecord.buses) {
+					writeString(out, bus.name);
+					writePod(out, bus.mediaType);
+					writePod(out, bus.direction);
+					writePod(out, bus.channelCount);
+					writePod(out, bus.busType);
+					writePod(out, bus.flags);
+					writePod(out, bus.speakerArrangement);
+				}
+			}
+		}
+
+		if (!out) {
+			std::cerr << "Error writing plugin cache \"" << cachePath << "\"" << std::endl;
+			return false;
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(tempPath, cachePath, ec);
+	if (ec) {
+		std::cerr << "Error replacing plugin cache \"" << cachePath << "\": " << ec.message() << std::endl;
+		return false;
+	}
+	return true;
+}
+
+int EasyVstScanner::scan()
+{
+	return scan(VST3::Hosting::Module::getModulePaths());
+}
+
+int EasyVstScanner::scan(const std::vector<std::string> &bundlePaths)
+{
+	std::unordered_map<std::string, size_t> cached;
+	for (size_t i = 0; i < _plugins.size(); ++i) {
+		cached[_plugins[i].path] = i;
+	}
+
+	std::vector<EasyVstPluginRecord> plugins;
+	plugins.reserve(bundlePaths.size());
+
+	int numProbed = 0;
+	for (const std::string &path : bundlePaths) {
+		EasyVstPluginRecord record;
+		record.path = path;
+		if (!fingerprintBundle(path, record.modifiedTime, record.fingerprint)) {
+			continue;
+		}
+
+		auto it = cached.find(path);
+		if (it != cached.end()) {
+			const EasyVstPluginRecord &previous = _plugins[it->second];
+			if (previous.modifiedTime == record.modifiedTime && previous.fingerprint == record.fingerprint) {
+				plugins.push_back(previous);
+				continue;
+			}
+		}
+
+		// A failed probe is recorded under the same fingerprint so the bundle is not loaded again until it changes
+		if (_probe(path, record)) {
+			++numProbed;
+		} else {
+			record.loadFailed = true;
+		}
+		plugins.push_back(std::move(record));
+	}
+
+	_plugins = std::move(plugins);
+	return numProbed;
+}
+
+const std::vector<EasyVstPluginRecord> &EasyVstScanner::plugins() const
+{
+	return _plugins;
+}
+
+const EasyVstPluginRecord *EasyVstScanner::find(const std::string &path) const
+{
+	for (const EasyVstPluginRecord &plugin : _plugins) {
+		if (plugin.path == path) {
+			return &plugin;
+		}
+	}
+	return nullptr;
+}
+
+bool EasyVstScanner::_probe(const std::string &path, EasyVstPluginRecord &record)
+{
+	std::string error;
+	VST3::Hosting::Module::Ptr module = EasyVst::_loadModule(path, error);
+	if (!module) {
+		_printError(path, error);
+		record.error = error;
+		return false;
+	}
+
+	EasyVst::_acquirePluginContext();
+
+	VST3::Hosting::PluginFactory factory = module->getFactory();
+	for (auto &classInfo : factory.classInfos()) {
+		EasyVstClassRecord classRecord;
+		classRecord.uid = classInfo.ID().toString();
+		classRecord.name = classInfo.name();
+		classRecord.category = classInfo.category();
+		classRecord.subCategories = classInfo.subCategoriesString();
+		classRecord.vendor = classInfo.vendor();
+		classRecord.version = classInfo.version();
+		classRecord.sdkVersion = classInfo.sdkVersion();
+
+		if (classInfo.category() == kVstAudioEffectClass) {
+			IPtr<PlugProvider> plugProvider = owned(NEW PlugProvider(factory, classInfo, true));
+			IPtr<IComponent> component = plugProvider ? plugProvider->getComponent() : nullptr;
+			FUnknownPtr<IAudioProcessor> audioEffect(component);
+			if (component && audioEffect) {
+				for (MediaType type : { kAudio, kEvent }) {
+					for (BusDirection direction : { kInput, kOutput }) {
+						int32 numBuses = component->getBusCount(type, direction);
+						for (int32 i = 0; i < numBuses; ++i) {
+							BusInfo info = {};
+							component->getBusInfo(type, direction, i, info);
+
+							EasyVstBusLayout bus;
+							bus.name = VST3::StringConvert::convert(info.name);
+							bus.mediaType = type;
+							bus.direction = direction;
+							bus.channelCount = info.channelCount;
+							bus.busType = info.busType;
+							bus.flags = info.flags;
+							if (type == kAudio) {
+								audioEffect->getBusArrangement(direction, i, bus.speakerArrangement);
+							}
+							classRecord.buses.push_back(bus);
+						}
+					}
+				}
+
+				FUnknownPtr<IProcessContextRequirements> contextRequirements(audioEffect);
+				if (contextRequirements) {
+					classRecord.processContextRequirements = contextRequirements->getProcessContextRequirements();
+				}
+				classRecord.supports64Bit = audioEffect->canProcessSampleSize(kSample64) == kResultTrue;
+
+				ProcessSetup setup = {};
+				setup.processMode = kRealtime;
+				setup.symbolicSampleSize = kSample32;
+				setup.maxSamplesPerBlock = 512;
+				setup.sampleRate = 48000.0;
+				if (audioEffect->setupProcessing(setup) == kResultOk && component->setActive(true) == kResultTrue) {
+					classRecord.latencySamples = audioEffect->getLatencySamples();
+					classRecord.tailSamples = audioEffect->getTailSamples();
+					component->setActive(false);
+				}
+
+				classRecord.probed = true;
+			} else {
+				_printError(path, "Could not instantiate audio processor for class \"" + classRecord.name + "\"");
+			}
+		}
+
+		record.classes.push_back(classRecord);
+	}
+
+	EasyVst::_releasePluginContext();
+
+	return true;
+}
+
+void EasyVstScanner::_printError(const std::string &path, const std::string &error)
+{
+	std::cerr << "Error scanning VST3 plugin \"" << path << "\": " << error << std::endl;
+}
@@ -0,0 +1,312 @@
+#include <EasyVstScheduler.h>
+
+#include <chrono>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace Steinberg;
+
+static const int SPIN_ITERATIONS = 2000;
+
+static int64 nowNs()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void EasyVstScheduler::WorkDeque::allocate(int capacity)
+{
+	int size = 1;
+	while (size < capacity) {
+		size <<= 1;
+	}
+	_buffer = std::vector<std::atomic<int>>(size);
+	_mask = size - 1;
+	clear();
+}
+
+void EasyVstScheduler::WorkDeque::clear()
+{
+	_top.store(0, std::memory_order_relaxed);
+	_bottom.store(0, std::memory_order_relaxed);
+}
+
+void EasyVstScheduler::WorkDeque::push(int node)
+{
+	int64 bottom = _bottom.load(std::memory_order_relaxed);
+	_buffer[bottom & _mask].store(node, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	_bottom.store(bottom + 1, std::memory_order_relaxed);
+}
+
+int EasyVstScheduler::WorkDeque::pop()
+{
+	int64 bottom = _bottom.load(std::memory_order_relaxed) - 1;
+	_bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64 top = _top.load(std::memory_order_relaxed);
+
+	if (top > bottom) {
+		_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return -1;
+	}
+
+	int node = _buffer[bottom & _mask].load(std::memory_order_relaxed);
+	if (top == bottom) {
+		if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			node = -1;
+		}
+		_bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+	return node;
+}
+
+int EasyVstScheduler::WorkDeque::steal()
+{
+	int64 top = _top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64 bottom = _bottom.load(std::memory_order_acquire);
+	if (top >= bottom) {
+		return -1;
+	}
+
+	int node = _buffer[top & _mask].load(std::memory_order_relaxed);
+	if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+		return -1;
+	}
+	return node;
+}
+
+EasyVstScheduler::EasyVstScheduler()
+{}
+
+EasyVstScheduler::~EasyVstScheduler()
+{
+	stop();
+}
+
+bool EasyVstScheduler::start(EasyVstGraph *graph, int numThreads, bool pinThreads)
+{
+	stop();
+
+	if (!graph || !graph->isPrepared()) {
+		_printError("Graph must be prepared before starting the scheduler");
+		return false;
+	}
+	if (numThreads < 1) {
+		numThreads = 1;
+	}
+#if !defined(_WIN32) && !defined(__linux__)
+	if (pinThreads && numThreads > 1) {
+		_printError("Thread pinning is not supported on this platform, workers run unpinned");
+	}
+#endif
+
+	_graph = graph;
+	int numNodes = _graph->numNodes();
+
+	_deques.clear();
+	for (int i = 0; i < numThreads; ++i) {
+		_deques.emplace_back(new WorkDeque());
+		_deques.back()->allocate(std::max(numNodes, 1));
+	}
+	_pending.reset(new std::atomic<int>[std::max(numNodes, 1)]);
+	_nodeDurationNs.assign(numNodes, 0);
+	_pathNs.assign(numNodes, 0);
+	_stats = {};
+
+	// Workers start from the cycle count seen here, so a process() call that runs before a worker
+	// gets scheduled still counts as a new cycle for it
+	_running.store(true);
+	uint64 startCycle = _cycle.load(std::memory_order_acquire);
+	for (int i = 1; i < numThreads; ++i) {
+		_threads.emplace_back(&EasyVstScheduler::_workerMain, this, i, pinThreads, startCycle);
+	}
+
+	return true;
+}
+
+void EasyVstScheduler::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(_wakeMutex);
+		_running.store(false);
+		_cycle.fetch_add(1);
+	}
+	_wakeCondition.notify_all();
+
+	for (std::thread &thread : _threads) {
+		thread.join();
+	}
+	_threads.clear();
+	_graph = nullptr;
+}
+
+bool EasyVstScheduler::process(int numSamples)
+{
+	if (!_graph) {
+		_printError("process() called before start()");
+		return false;
+	}
+
+	int numNodes = _graph->numNodes();
+	if (numNodes == 0) {
+		return true;
+	}
+
+	int64 cycleStart = nowNs();
+
+	_numSamples = numSamples;
+	_failed.store(false, std::memory_order_relaxed);
+	_remainingNodes.store(numNodes, std::memory_order_relaxed);
+
+	int numDeques = static_cast<int>(_deques.size());
+	for (int i = 0; i < numDeques; ++i) {
+		_deques[i]->clear();
+	}
+
+	int nextDeque = 0;
+	for (int i = 0; i < numNodes; ++i) {
+		int numPredecessors = _graph->numPredecessors(i);
+		_pending[i].store(numPredecessors, std::memory_order_relaxed);
+		if (numPredecessors == 0) {
+			_deques[nextDeque]->push(i);
+			nextDeque = (nextDeque + 1) % numDeques;
+		}
+	}
+
+	_workersInCycle.store(static_cast<int>(_threads.size()), std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(_wakeMutex);
+		_cycle.fetch_add(1, std::memory_order_release);
+	}
+	_wakeCondition.notify_all();
+
+	_runCycle(0);
+
+	while (_workersInCycle.load(std::memory_order_acquire) > 0) {
+		std::this_thread::yield();
+	}
+
+	_computeStats(nowNs() - cycleStart);
+
+	return !_failed.load(std::memory_order_relaxed);
+}
+
+const EasyVstCycleStats &EasyVstScheduler::cycleStats() const
+{
+	return _stats;
+}
+
+void EasyVstScheduler::_workerMain(int index, bool pin, uint64 startCycle)
+{
+	if (pin) {
+#ifdef _WIN32
+		unsigned int numCores = std::max(1u, std::thread::hardware_concurrency());
+		if (SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << (index % numCores)) == 0) {
+			_printError("Failed to pin worker thread");
+		}
+#elif defined(__linux__)
+		unsigned int numCores = std::max(1u, std::thread::hardware_concurrency());
+		cpu_set_t cpuSet;
+		CPU_ZERO(&cpuSet);
+		CPU_SET(index % numCores, &cpuSet);
+		if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0) {
+			_printError("Failed to pin worker thread");
+		}
+#endif
+	}
+
+	uint64 lastCycle = startCycle;
+	while (true) {
+		uint64 cycle = _cycle.load(std::memory_order_acquire);
+		for (int i = 0; i < SPIN_ITERATIONS && cycle == lastCycle; ++i) {
+			std::this_thread::yield();
+			cycle = _cycle.load(std::memory_order_acquire);
+		}
+		if (cycle == lastCycle) {
+			std::unique_lock<std::mutex> lock(_wakeMutex);
+			_wakeCondition.wait(lock, [&] {
+				return _cycle.load(std::memory_order_acquire) != lastCycle;
+			});
+			cycle = _cycle.load(std::memory_order_acquire);
+		}
+		lastCycle = cycle;
+
+		if (!_running.load(std::memory_order_acquire)) {
+			break;
+		}
+
+		_runCycle(index);
+		_workersInCycle.fetch_sub(1, std::memory_order_release);
+	}
+}
+
+void EasyVstScheduler::_runCycle(int index)
+{
+	WorkDeque &own = *_deques[index];
+	int numDeques = static_cast<int>(_deques.size());
+	int victim = index;
+
+	while (_remainingNodes.load(std::memory_order_acquire) > 0) {
+		int node = own.pop();
+		for (int i = 1; node < 0 && i < numDeques; ++i) {
+			victim = (victim + 1) % numDeques;
+			if (victim != index) {
+				node = _deques[victim]->steal();
+			}
+		}
+
+		if (node >= 0) {
+			_runNode(index, node);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+}
+
+void EasyVstScheduler::_runNode(int index, int node)
+{
+	int64 start = nowNs();
+	if (!_graph->processNode(node, _numSamples)) {
+		_failed.store(true, std::memory_order_relaxed);
+	}
+	_nodeDurationNs[node] = nowNs() - start;
+
+	for (int successor : _graph->successors(node)) {
+		if (_pending[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			_deques[index]->push(successor);
+		}
+	}
+
+	_remainingNodes.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void EasyVstScheduler::_computeStats(int64 wallTimeNs)
+{
+	int64 totalWorkNs = 0, criticalPathNs = 0;
+	std::fill(_pathNs.begin(), _pathNs.end(), 0);
+
+	for (int node : _graph->processingOrder()) {
+		int64 finish = _pathNs[node] + _nodeDurationNs[node];
+		totalWorkNs += _nodeDurationNs[node];
+		criticalPathNs = std::max(criticalPathNs, finish);
+		for (int successor : _graph->successors(node)) {
+			_pathNs[successor] = std::max(_pathNs[successor], finish);
+		}
+	}
+
+	_stats.wallTimeNs = wallTimeNs;
+	_stats.criticalPathNs = criticalPathNs;
+	_stats.totalWorkNs = totalWorkNs;
+	_stats.numNodes = _graph->numNodes();
+}
+
+void EasyVstScheduler::_printError(const std::string &error)
+{
+	std::cerr << "EasyVstScheduler error: " << error << std::endl;
+}
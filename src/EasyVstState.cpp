@@ -0,0 +1,139 @@
+#include <EasyVstState.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Steinberg;
+
+IMPLEMENT_FUNKNOWN_METHODS(EasyVstMemoryStream, IBStream, IBStream::iid)
+
+EasyVstMemoryStream::EasyVstMemoryStream()
+{
+	FUNKNOWN_CTOR
+}
+
+EasyVstMemoryStream::~EasyVstMemoryStream()
+{}
+
+void EasyVstMemoryStream::reserve(size_t size)
+{
+	if (_data.size() < size) {
+		_data.resize(size);
+	}
+}
+
+void EasyVstMemoryStream::rewind()
+{
+	_cursor = 0;
+}
+
+void EasyVstMemoryStream::clear()
+{
+	_size = 0;
+	_cursor = 0;
+}
+
+const char *EasyVstMemoryStream::data() const
+{
+	return _data.data();
+}
+
+void EasyVstMemoryStream::assign(const void *data, size_t size)
+{
+	reserve(size);
+	if (size > 0) {
+		std::memcpy(_data.data(), data, size);
+	}
+	_size = size;
+	_cursor = 0;
+}
+
+size_t EasyVstMemoryStream::size() const
+{
+	return _size;
+}
+
+tresult PLUGIN_API EasyVstMemoryStream::read(void *buffer, int32 numBytes, int32 *numBytesRead)
+{
+	if (numBytes < 0 || (numBytes > 0 && !buffer)) {
+		return kInvalidArgument;
+	}
+
+	size_t available = _cursor < _size ? _size - _cursor : 0;
+	size_t count = std::min(available, static_cast<size_t>(numBytes));
+	if (count > 0) {
+		std::memcpy(buffer, _data.data() + _cursor, count);
+		_cursor += count;
+	}
+
+	if (numBytesRead) {
+		*numBytesRead = static_cast<int32>(count);
+	}
+
+	return kResultTrue;
+}
+
+tresult PLUGIN_API EasyVstMemoryStream::write(void *buffer, int32 numBytes, int32 *numBytesWritten)
+{
+	if (numBytes < 0 || (numBytes > 0 && !buffer)) {
+		return kInvalidArgument;
+	}
+
+	size_t end = _cursor + static_cast<size_t>(numBytes);
+	if (end > _data.size()) {
+		_data.resize(std::max(end, _data.size() * 2));
+	}
+	if (_cursor > _size) {
+		std::memset(_data.data() + _size, 0, _cursor - _size);
+	}
+	if (numBytes > 0) {
+		std::memcpy(_data.data() + _cursor, buffer, numBytes);
+	}
+	_cursor = end;
+	_size = std::max(_size, end);
+
+	if (numBytesWritten) {
+		*numBytesWritten = numBytes;
+	}
+
+	return kResultTrue;
+}
+
+tresult PLUGIN_API EasyVstMemoryStream::seek(int64 pos, int32 mode, int64 *result)
+{
+	int64 base = 0;
+	switch (mode) {
+	case kIBSeekSet:
+		base = 0;
+		break;
+	case kIBSeekCur:
+		base = static_cast<int64>(_cursor);
+		break;
+	case kIBSeekEnd:
+		base = static_cast<int64>(_size);
+		break;
+	default:
+		return kInvalidArgument;
+	}
+
+	if (base + pos < 0) {
+		return kInvalidArgument;
+	}
+	_cursor = static_cast<size_t>(base + pos);
+
+	if (result) {
+		*result = static_cast<int64>(_cursor);
+	}
+
+	return kResultTrue;
+}
+
+tresult PLUGIN_API EasyVstMemoryStream::tell(int64 *pos)
+{
+	if (!pos) {
+		return kInvalidArgument;
+	}
+
+	*pos = static_cast<int64>(_cursor);
+	return kResultTrue;
+}
@@ -0,0 +1,266 @@
+#include <EasyVstTrace.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+using namespace Steinberg;
+
+std::atomic<bool> EasyVstTrace::_enabled{false};
+
+namespace {
+struct ThreadBuffer {
+	EasyVstRingBuffer<EasyVstTraceSpan> spans;
+	std::atomic<uint64> dropped{0};
+	std::atomic<bool> alive{true};
+	uint32 threadId = 0;
+};
+
+struct TraceState {
+	std::mutex mutex;
+	std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+	uint32 nextThreadId = 1;
+	int capacity = 65536;
+	uint64 retiredDropped = 0;
+
+	std::FILE *file = nullptr;
+	bool firstEvent = true;
+	int processId = 0;
+	int64 originNs = 0;
+
+	std::thread flushThread;
+	std::condition_variable wake;
+	int flushIntervalMs = 100;
+	bool flushing = false;
+};
+
+TraceState &traceState()
+{
+	static TraceState state;
+	return state;
+}
+
+// Marks the buffer as orphaned when its thread exits; the flush thread drains and drops it
+struct ThreadHandle {
+	std::shared_ptr<ThreadBuffer> buffer;
+
+	~ThreadHandle()
+	{
+		if (buffer) {
+			buffer->alive.store(false, std::memory_order_release);
+		}
+	}
+};
+
+thread_local ThreadHandle threadHandle;
+
+void writeJsonString(std::FILE *file, const char *text)
+{
+	std::fputc('"', file);
+	for (const char *c = text; *c; ++c) {
+		unsigned char character = static_cast<unsigned char>(*c);
+		if (character == '"' || character == '\\') {
+			std::fputc('\\', file);
+			std::fputc(character, file);
+		} else if (character < 0x20) {
+			std::fprintf(file, "\\u%04x", character);
+		} else {
+			std::fputc(character, file);
+		}
+	}
+	std::fputc('"', file);
+}
+
+// Requires the state mutex
+void flushBuffers(TraceState &state)
+{
+	EasyVstTraceSpan span;
+	for (auto it = state.buffers.begin(); it != state.buffers.end();) {
+		ThreadBuffer &buffer = **it;
+		bool alive = buffer.alive.load(std::memory_order_acquire);
+
+		while (buffer.spans.pop(span)) {
+			if (!state.file) {
+				continue;
+			}
+
+			std::fputs(state.firstEvent ? "\n" : ",\n", state.file);
+			state.firstEvent = false;
+			std::fputs("{\"name\":", state.file);
+			writeJsonString(state.file, span.name ? span.name : "");
+			std::fprintf(state.file, ",\"cat\":\"easyvst\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%u,\"args\":{\"instance\":",
+				(span.startNs - state.originNs) / 1000.0, (span.endNs - span.startNs) / 1000.0, state.processId, buffer.threadId);
+			writeJsonString(state.file, span.instance);
+			if (span.blockSize >= 0) {
+				std::fprintf(state.file, ",\"blockSize\":%d", span.blockSize);
+			}
+			std::fputs("}}", state.file);
+		}
+
+		if (!alive) {
+			state.retiredDropped += buffer.dropped.load(std::memory_order_relaxed);
+			it = state.buffers.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	if (state.file) {
+		std::fflush(state.file);
+	}
+}
+
+void flushMain()
+{
+	TraceState &state = traceState();
+	std::unique_lock<std::mutex> lock(state.mutex);
+	while (state.flushing) {
+		state.wake.wait_for(lock, std::chrono::milliseconds(state.flushIntervalMs), [&state] { return !state.flushing; });
+		flushBuffers(state);
+	}
+}
+}
+
+EasyVstTrace::Scope::Scope(const char *name, const std::string &instance, int32 blockSize) :
+	_name(name),
+	_blockSize(blockSize)
+{
+	if (isEnabled()) {
+		// Copied up front because the instance may rename itself or be destroyed inside the span
+		size_t length = std::min(instance.size(), static_cast<size_t>(EasyVstTraceSpan::MAX_INSTANCE_NAME - 1));
+		std::memcpy(_instance, instance.data(), length);
+		_instance[length] = '\0';
+		_startNs = nowNs();
+	}
+}
+
+EasyVstTrace::Scope::~Scope()
+{
+	if (_startNs != 0) {
+		record(_name, _instance, _blockSize, _startNs, nowNs());
+	}
+}
+
+bool EasyVstTrace::start(const std::string &path, int capacityPerThread, int flushIntervalMs)
+{
+	stop();
+
+	TraceState &state = traceState();
+	{
+		std::lock_guard<std::mutex> lock(state.mutex);
+
+		state.file = std::fopen(path.c_str(), "w");
+		if (!state.file) {
+			std::cerr << "EasyVstTrace error: Failed to create \"" << path << "\"" << std::endl;
+			return false;
+		}
+		std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", state.file);
+
+		state.firstEvent = true;
+		state.capacity = std::max(capacityPerThread, 1);
+		state.flushIntervalMs = std::max(flushIntervalMs, 1);
+		state.originNs = nowNs();
+#if defined(__unix__) || defined(__APPLE__)
+		state.processId = static_cast<int>(getpid());
+#endif
+		state.flushing = true;
+	}
+	state.flushThread = std::thread(flushMain);
+
+	_enabled.store(true, std::memory_order_release);
+	return true;
+}
+
+void EasyVstTrace::stop()
+{
+	_enabled.store(false, std::memory_order_release);
+
+	TraceState &state = traceState();
+	{
+		std::lock_guard<std::mutex> lock(state.mutex);
+		state.flushing = false;
+	}
+	state.wake.notify_all();
+	if (state.flushThread.joinable()) {
+		state.flushThread.join();
+	}
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+	flushBuffers(state);
+	if (state.file) {
+		std::fputs("\n]}\n", state.file);
+		std::fclose(state.file);
+		state.file = nullptr;
+	}
+}
+
+bool EasyVstTrace::isEnabled()
+{
+	return _enabled.load(std::memory_order_relaxed);
+}
+
+void EasyVstTrace::registerThread()
+{
+	if (threadHandle.buffer) {
+		return;
+	}
+
+	TraceState &state = traceState();
+	std::shared_ptr<ThreadBuffer> buffer = std::make_shared<ThreadBuffer>();
+
+	std::lock_guard<std::mutex> lock(state.mutex);
+	buffer->spans.reset(state.capacity);
+	buffer->threadId = state.nextThreadId++;
+	state.buffers.push_back(buffer);
+	threadHandle.buffer = buffer;
+}
+
+void EasyVstTrace::record(const char *name, const char *instance, int32 blockSize, int64 startNs, int64 endNs)
+{
+	if (!isEnabled()) {
+		return;
+	}
+	if (!threadHandle.buffer) {
+		registerThread();
+	}
+
+	EasyVstTraceSpan span;
+	span.name = name;
+	std::strncpy(span.instance, instance ? instance : "", EasyVstTraceSpan::MAX_INSTANCE_NAME - 1);
+	span.startNs = startNs;
+	span.endNs = endNs;
+	span.blockSize = blockSize;
+
+	ThreadBuffer &buffer = *threadHandle.buffer;
+	if (!buffer.spans.push(span)) {
+		buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+Steinberg::uint64 EasyVstTrace::droppedSpans()
+{
+	TraceState &state = traceState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+
+	uint64 dropped = state.retiredDropped;
+	for (const auto &buffer : state.buffers) {
+		dropped += buffer->dropped.load(std::memory_order_relaxed);
+	}
+	return dropped;
+}
+
+Steinberg::int64 EasyVstTrace::nowNs()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,205 @@
+#include <EasyVstTransport.h>
+
+#include <chrono>
+#include <cmath>
+
+using namespace Steinberg;
+using namespace Steinberg::Vst;
+
+namespace {
+const double MIDI_CLOCKS_PER_QUARTER_NOTE = 24.0;
+}
+
+EasyVstTransport::EasyVstTransport()
+{
+	_context.sampleRate = 44100.0;
+	_context.tempo = 120.0;
+	_context.timeSigNumerator = 4;
+	_context.timeSigDenominator = 4;
+	_updateRates();
+}
+
+EasyVstTransport::~EasyVstTransport()
+{}
+
+void EasyVstTransport::setSampleRate(double sampleRate)
+{
+	if (sampleRate <= 0.0) {
+		return;
+	}
+
+	_context.sampleRate = sampleRate;
+	_updateRates();
+}
+
+void EasyVstTransport::setTempo(double tempo)
+{
+	if (tempo <= 0.0) {
+		return;
+	}
+
+	_context.tempo = tempo;
+	_updateRates();
+}
+
+void EasyVstTransport::setTimeSignature(int32 numerator, int32 denominator)
+{
+	if (numerator <= 0 || denominator <= 0) {
+		return;
+	}
+
+	_context.timeSigNumerator = numerator;
+	_context.timeSigDenominator = denominator;
+	_updateRates();
+	_updateBarPosition();
+}
+
+void EasyVstTransport::setCycle(bool active, TQuarterNotes start, TQuarterNotes end)
+{
+	_context.cycleStartMusic = start;
+	_context.cycleEndMusic = end;
+	if (active && end > start) {
+		_context.state |= ProcessContext::kCycleActive;
+	} else {
+		_context.state &= ~ProcessContext::kCycleActive;
+	}
+}
+
+void EasyVstTransport::setPlaying(bool playing)
+{
+	if (playing) {
+		_context.state |= ProcessContext::kPlaying;
+	} else {
+		_context.state &= ~(ProcessContext::kPlaying | ProcessContext::kRecording);
+	}
+}
+
+void EasyVstTransport::setRecording(bool recording)
+{
+	if (recording) {
+		_context.state |= ProcessContext::kRecording | ProcessContext::kPlaying;
+	} else {
+		_context.state &= ~ProcessContext::kRecording;
+	}
+}
+
+void EasyVstTransport::setPosition(int64 projectTimeSamples)
+{
+	_context.projectTimeSamples = projectTimeSamples;
+	_context.projectTimeMusic = projectTimeSamples * _quarterNotesPerSample;
+	_updateBarPosition();
+	_updateClock();
+}
+
+void EasyVstTransport::advance(int numSamples)
+{
+	_context.continousTimeSamples += numSamples;
+
+	if (_context.state & ProcessContext::kPlaying) {
+		_context.projectTimeSamples += numSamples;
+		_context.projectTimeMusic += numSamples * _quarterNotesPerSample;
+
+		// Cycles wrap at block granularity, the block that crosses the end finishes past it
+		if ((_context.state & ProcessContext::kCycleActive) && _context.projectTimeMusic >= _context.cycleEndMusic) {
+			TQuarterNotes cycleLength = _context.cycleEndMusic - _context.cycleStartMusic;
+			_context.projectTimeMusic -= cycleLength;
+			_context.projectTimeSamples -= static_cast<int64>(std::llround(cycleLength / _quarterNotesPerSample));
+			_updateBarPosition();
+		} else {
+			while (_context.projectTimeMusic >= _context.barPositionMusic + _quarterNotesPerBar) {
+				_context.barPositionMusic += _quarterNotesPerBar;
+			}
+		}
+	}
+
+	uint32 requirements = _requirements.load(std::memory_order_relaxed);
+	if (requirements & IProcessContextRequirements::kNeedSamplesToNextClock) {
+		_updateClock();
+	}
+	if (requirements & IProcessContextRequirements::kNeedSystemTime) {
+		_updateSystemTime();
+	}
+}
+
+void EasyVstTransport::addRequirements(uint32 requirements)
+{
+	uint32 previous = _requirements.fetch_or(requirements, std::memory_order_relaxed);
+	if ((requirements & ~previous) & IProcessContextRequirements::kNeedSamplesToNextClock) {
+		_updateClock();
+	}
+	if ((requirements & ~previous) & IProcessContextRequirements::kNeedSystemTime) {
+		_updateSystemTime();
+	}
+}
+
+void EasyVstTransport::fill(ProcessContext &context, uint32 requirements) const
+{
+	context.state = 0;
+	context.projectTimeSamples = _context.projectTimeSamples;
+
+	if (requirements & IProcessContextRequirements::kNeedTransportState) {
+		context.state |= _context.state & (ProcessContext::kPlaying | ProcessContext::kRecording | ProcessContext::kCycleActive);
+	}
+	if (requirements & IProcessContextRequirements::kNeedSystemTime) {
+		context.systemTime = _context.systemTime;
+		context.state |= ProcessContext::kSystemTimeValid;
+	}
+	if (requirements & IProcessContextRequirements::kNeedContinousTimeSamples) {
+		context.continousTimeSamples = _context.continousTimeSamples;
+		context.state |= ProcessContext::kContTimeValid;
+	}
+	if (requirements & IProcessContextRequirements::kNeedProjectTimeMusic) {
+		context.projectTimeMusic = _context.projectTimeMusic;
+		context.state |= ProcessContext::kProjectTimeMusicValid;
+	}
+	if (requirements & IProcessContextRequirements::kNeedBarPositionMusic) {
+		context.barPositionMusic = _context.barPositionMusic;
+		context.state |= ProcessContext::kBarPositionValid;
+	}
+	if (requirements & IProcessContextRequirements::kNeedCycleMusic) {
+		context.cycleStartMusic = _context.cycleStartMusic;
+		context.cycleEndMusic = _context.cycleEndMusic;
+		context.state |= ProcessContext::kCycleValid;
+	}
+	if (requirements & IProcessContextRequirements::kNeedSamplesToNextClock) {
+		context.samplesToNextClock = _context.samplesToNextClock;
+		context.state |= ProcessContext::kClockValid;
+	}
+	if (requirements & IProcessContextRequirements::kNeedTempo) {
+		context.tempo = _context.tempo;
+		context.state |= ProcessContext::kTempoValid;
+	}
+	if (requirements & IProcessContextRequirements::kNeedTimeSignature) {
+		context.timeSigNumerator = _context.timeSigNumerator;
+		context.timeSigDenominator = _context.timeSigDenominator;
+		context.state |= ProcessContext::kTimeSigValid;
+	}
+}
+
+const ProcessContext &EasyVstTransport::context() const
+{
+	return _context;
+}
+
+void EasyVstTransport::_updateRates()
+{
+	_quarterNotesPerSample = _context.tempo / (60.0 * _context.sampleRate);
+	_quarterNotesPerBar = _context.timeSigNumerator * 4.0 / _context.timeSigDenominator;
+}
+
+void EasyVstTransport::_updateBarPosition()
+{
+	_context.barPositionMusic = std::floor(_context.projectTimeMusic / _quarterNotesPerBar) * _quarterNotesPerBar;
+}
+
+void EasyVstTransport::_updateClock()
+{
+	double clocks = _context.projectTimeMusic * MIDI_CLOCKS_PER_QUARTER_NOTE;
+	double clocksToNext = std::ceil(clocks) - clocks;
+	_context.samplesToNextClock = static_cast<int32>(std::lround(clocksToNext / (MIDI_CLOCKS_PER_QUARTER_NOTE * _quarterNotesPerSample)));
+}
+
+void EasyVstTransport::_updateSystemTime()
+{
+	_context.systemTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,20 @@
+// Helper process for EasyVst::initSandboxed(). Build it together with the EasyVst sources as an
+// "easyvst-sandbox-host" executable and install it next to the host, or point EasyVstSandbox::setHelperPath()
+// at it. The host starts it with the shared memory descriptor, the region's initial size and its own pid.
+#include <EasyVstSandbox.h>
+
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char **argv)
+{
+	if (argc != 4) {
+		std::cerr << "Usage: easyvst-sandbox-host <fd> <size> <parent pid>" << std::endl;
+		return 1;
+	}
+
+	int fd = std::atoi(argv[1]);
+	size_t initialSize = static_cast<size_t>(std::strtoull(argv[2], nullptr, 10));
+	int parentPid = std::atoi(argv[3]);
+	return EasyVstSandbox::runChild(fd, initialSize, parentPid);
+}